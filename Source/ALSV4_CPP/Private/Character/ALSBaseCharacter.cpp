@@ -15,11 +15,13 @@
 #include "Character/Animation/ALSCharacterAnimInstance.h"
 #include "Library/ALSMathLibrary.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/TimelineComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Curves/CurveVector.h"
 #include "Curves/CurveFloat.h"
 #include "Character/ALSCharacterMovementComponent.h"
+#include "Character/ALSRootMotionSource_Mantle.h"
+#include "Character/ALSHitboxHistoryComponent.h"
+#include "Character/ALSWindFieldSubsystem.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/GameplayStatics.h"
@@ -42,7 +44,6 @@ AALSBaseCharacter::AALSBaseCharacter(const FObjectInitializer& ObjectInitializer
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<UALSCharacterMovementComponent>(CharacterMovementComponentName))
 {
 	PrimaryActorTick.bCanEverTick = true;
-	MantleTimeline = CreateDefaultSubobject<UTimelineComponent>(FName(TEXT("MantleTimeline")));
 	bUseControllerRotationYaw = 0;
 	bReplicates = true;
 	SetReplicatingMovement(true);
@@ -53,6 +54,7 @@ AALSBaseCharacter::AALSBaseCharacter(const FObjectInitializer& ObjectInitializer
 	FirstPersonCameraComponent->SetupAttachment(CameraPoll);
 	//FirstPersonCameraComponent->SetRelativeLocation(FVector(-39.56f, 1.75f, 64.f)); // Position the camera
 	FirstPersonCameraComponent->bUsePawnControlRotation = false;
+	HitboxHistory = CreateDefaultSubobject<UALSHitboxHistoryComponent>(TEXT("HitboxHistory"));
 	
 	Health = 100.f;
 	bAlwaysRelevant = true;
@@ -121,13 +123,27 @@ void AALSBaseCharacter::UpdateCameraRotation(FRotator& RotationOffset, FRotator&
 
 void AALSBaseCharacter::Gravitate(FVector SourceLocation, FVector HitLocation, float Direction, float Strength)
 {
-	FVector thisLocation = GetActorLocation();
-	float Distance = FMath::Abs((thisLocation - SourceLocation).Size());
-	float ForceScale = FMath::GetMappedRangeValueClamped({ 0.0f, 3000.0f }, { 1.0f, 0.f }, Distance);
-	FVector DirectionTo = UKismetMathLibrary::GetDirectionUnitVector(HitLocation, SourceLocation);
-	FVector Force = Strength * ForceScale * Direction * DirectionTo;
-	GetMyMovementComponent()->AddForce(Force * .05f);
-	UE_LOG(LogTemp, Log, TEXT(" AALSBaseCharacter::Gravitate"));
+	// The pull itself is evaluated by the movement component's gravity well channel, so the owning client predicts it
+	ForceChannels.WellLocation = SourceLocation;
+	ForceChannels.WellStrength = Strength * Direction * .05f;
+	ForceChannels.WellRadius = 3000.0f;
+	LastGravitateTime = GetWorld()->GetTimeSeconds();
+}
+
+void AALSBaseCharacter::SetChannelForce(EALSForceChannel Channel, FVector Force)
+{
+	switch (Channel)
+	{
+	case EALSForceChannel::Entanglement:
+		ForceChannels.EntanglementForce = Force;
+		break;
+	case EALSForceChannel::Scripted:
+		ForceChannels.ScriptedForce = Force;
+		break;
+	default:
+		// Wind and gravity wells are evaluated from the flow field and Gravitate
+		break;
+	}
 }
 
 	///Weapons Weapons etc
@@ -513,11 +529,11 @@ void AALSBaseCharacter::SetCurrentRoomIDToPredicted()
 
 
 
-int32 AALSBaseCharacter::GetCurrentRoomID()
+int32 AALSBaseCharacter::GetCurrentRoomID() const
 {
 	return CurrentRoomID;
 }
-int32 AALSBaseCharacter::GetPredictedNextRoomID()
+int32 AALSBaseCharacter::GetPredictedNextRoomID() const
 {
 
 return GridSample.PredictedNextRoomID;
@@ -539,16 +555,12 @@ void AALSBaseCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 	DOREPLIFETIME(AALSBaseCharacter, Health);
 	DOREPLIFETIME(AALSBaseCharacter, CurrentWeapon);
 	DOREPLIFETIME(AALSBaseCharacter, TargetRagdollLocation);
+	DOREPLIFETIME(AALSBaseCharacter, ForceChannels);
 
 	DOREPLIFETIME_CONDITION(AALSBaseCharacter, Arsenal, COND_OwnerOnly);
 
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedQuatYawRotation, COND_SkipOwner);
 	DOREPLIFETIME_CONDITION(AALSBaseCharacter, CameraRotation, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, DeltaPitch, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, DeltaYaw, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedCurrentAcceleration, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedControlRotation, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedGravityDirection, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedEssentials, COND_SkipOwner);
 	
 
 	DOREPLIFETIME(AALSBaseCharacter, DesiredGait);
@@ -558,6 +570,7 @@ void AALSBaseCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Ou
 	DOREPLIFETIME_CONDITION(AALSBaseCharacter, RotationMode, COND_SkipOwner);
 	DOREPLIFETIME_CONDITION(AALSBaseCharacter, OverlayState, COND_SkipOwner);
 	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ViewMode, COND_SkipOwner);
+	DOREPLIFETIME_CONDITION(AALSBaseCharacter, ReplicatedMantle, COND_SkipOwner);
 }
 
 int32 AALSBaseCharacter::GetMaxHealth() const
@@ -578,31 +591,6 @@ void AALSBaseCharacter::Replicated_PlayMontage_Implementation(UAnimMontage* mont
 	Server_PlayMontage(montage, track);
 }
 
-void AALSBaseCharacter::ClientCalculateFlow_Implementation(ARoomDataHelper* DataHelper, const TArray<FFloatBool>& AirCurrentData) const
-{
-
-	//UE_LOG(LogTemp, Error, TEXT("ClientCalculateFlow_Implementation on %s "), *GetFName().ToString());
-	DataHelper->CaclulateFlowBlendAsync(AirCurrentData);
-	//DataHelper->ReturnAsyncCompressedForces.BindUObject(this, &AALSBaseCharacter::ServerUpdateFlow); //see above in wiki
-	//DataHelper->AsyncCompressedForcesDelegate.AddDynamic(this, &AALSBaseCharacter::ServerUpdateFlow);
-	
-}
-
-
-void AALSBaseCharacter::ServerUpdateFlow_Implementation(const FCompressedForceArray& OutCompressedForceArray, ARoomDataHelper* BroadcastingDataHelper)
-{
-	//const FVector2D Scale = FVector2D(10.f, 10.f);
-	//GEngine->AddOnScreenDebugMessage(-1, 1.5f, FColor::White, TEXT("Bigger???"), true, Scale);
-	GEngine->AddOnScreenDebugMessage(-10, 20.f, FColor::Green, FString::Printf(TEXT("ServerUpdateFlow_Implementation CALLED!!!!!!!")));
-	UE_LOG(LogTemp, Log, TEXT("ServerUpdateFlow_Implementation CALLED!!!!!!!"));
-	BroadcastingDataHelper->CompressedForceArray = OutCompressedForceArray;
-}
-
-bool AALSBaseCharacter::ServerUpdateFlow_Validate(const FCompressedForceArray& OutCompressedForceArray, ARoomDataHelper* BroadcastingDataHelper)
-{
-	return true;
-}
-
 void AALSBaseCharacter::BeginPlay()
 {
 	Super::BeginPlay();
@@ -615,15 +603,6 @@ void AALSBaseCharacter::BeginPlay()
 	// If we're in networked game, disable curved movement
 	bDisableCurvedMovement = !IsNetMode(ENetMode::NM_Standalone);
 
-	FOnTimelineFloat TimelineUpdated;
-	FOnTimelineEvent TimelineFinished;
-	TimelineUpdated.BindUFunction(this, FName(TEXT("MantleUpdate")));
-	TimelineFinished.BindUFunction(this, FName(TEXT("MantleEnd")));
-	MantleTimeline->SetTimelineFinishedFunc(TimelineFinished);
-	MantleTimeline->SetLooping(false);
-	MantleTimeline->SetTimelineLengthMode(TL_TimelineLength);
-	MantleTimeline->AddInterpFloat(MantleTimelineCurve, TimelineUpdated);
-
 	// Make sure the mesh and animbp update after the CharacterBP to ensure it gets the most recent values.
 	GetMesh()->AddTickPrerequisiteActor(this);
 
@@ -671,6 +650,10 @@ void AALSBaseCharacter::BeginPlay()
 
 	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
 
+	if (UALSWindFieldSubsystem* WindField = UALSWindFieldSubsystem::Get(this))
+	{
+		WindField->RegisterCharacter(this);
+	}
 	
 	//SpawnWeapon(EWeaponType::SingleShotTestGun);
 	
@@ -722,6 +705,12 @@ void AALSBaseCharacter::Tick(float DeltaTime)
 
 	if (HasAuthority())
 	{
+		// The gravity gun calls Gravitate every tick it holds us
+		if (ForceChannels.WellStrength != 0.0f && GetWorld()->GetTimeSeconds() - LastGravitateTime > 0.1f)
+		{
+			ForceChannels.WellStrength = 0.0f;
+		}
+
 		AALSPlayerController* OwnerController = Cast<AALSPlayerController>(this);
 		if (OwnerController != NULL)
 		{
@@ -764,39 +753,19 @@ void AALSBaseCharacter::Tick(float DeltaTime)
 		UE_LOG(LogClass, Error, TEXT("CurrentWeapon NULL"));
 	}
 	**/
-	//UE_LOG(LogClass, Warning, TEXT(" ALSBaseCharacter Tick: WindForce: %s"), *WindForce.ToString());
-	WindForce = FMath::Lerp(WindForce, GridSample.Force, DeltaTime * 2.f);
-
-	WindForce.X = FMath::Clamp(WindForce.X, -3000.f, 3000.f);
-	WindForce.Y = FMath::Clamp(WindForce.Y, -3000.f, 3000.f);
-	WindForce.Z = FMath::Clamp(WindForce.Z, -3000.f, 3000.f);
-	FVector WindDirection = UKismetMathLibrary::GetDirectionUnitVector(FVector::ZeroVector, FVector::ZeroVector + WindForce);
+	// The wind field subsystem already sampled, smoothed and resolved the wind for us this frame
 	if (MovementState == EALSMovementState::Ragdoll)
 	{	
-		float VelocityDot = WindDirection | UKismetMathLibrary::GetDirectionUnitVector(FVector::ZeroVector, FVector::ZeroVector + LastRagdollVelocity);
-		FVector RidingWindForce =   WindForce - (LastRagdollVelocity.Size() * WindDirection * FMath::Clamp(VelocityDot, 0.f, 1.f));
-		GetMesh()->AddForceToAllBodiesBelow(RidingWindForce, FName(TEXT("Pelvis")), true, true);
+		GetMesh()->AddForceToAllBodiesBelow(WindFieldSample.RagdollForce, FName(TEXT("Pelvis")), true, true);
 		//GetMesh()->AddForceToAllBodiesBelow(ConstantForce - (RagdollVelocity * FMath::Clamp(VelocityDot, 0.f, 1.f)), FName(TEXT("Pelvis")), true, true);
 			//UE_LOG(LogClass, Warning, TEXT("basecharacter ragdoll velocity = %f"), GetMesh()->GetPhysicsLinearVelocity().Size());
 			//UE_LOG(LogClass, Warning, TEXT("basecharacter ragdoll VelocityDot = %f"), VelocityDot);
-			//UE_LOG(LogClass, Warning, TEXT("basecharacter ragdoll WindForce = %f"), WindForce);
-		//UE_LOG(LogClass, Warning, TEXT("basecharacter WindForce = %f"), WindForce.Size());	
-	}
-	else
-	{
-		FVector PlayerVelocity = GetMyMovementComponent()->Velocity;
-		float VelocityDot = WindDirection | UKismetMathLibrary::GetDirectionUnitVector(FVector::ZeroVector, FVector::ZeroVector + PlayerVelocity);
-		FVector RidingWindForce = WindForce - (PlayerVelocity.Size() * WindDirection * FMath::Clamp(VelocityDot, 0.f, 1.f));
-		//DrawDebugLine(this->GetWorld(), GetActorLocation(), GridSample.Location, FColor::Red, false, .01f, 0, 4.f);
-		
-		GetMyMovementComponent()->AddForce(RidingWindForce);
-
-		DrawDebugDirectionalArrow(GetWorld(), GridSample.Location, GridSample.Location + (RidingWindForce.Normalize() * 100.f), 50.f, FColor::Purple, false, .25f, 0, 5.f);
-		//UGameplayStatics::GetViewProjectionMatrix(CameraView, UnusedViewMatrix, UnusedProjectionMatrix, ViewProjectionMatrix);
-		//DrawDebugFrustum(GetWorld(), FirstPersonCameraComponent->matrix)
 	}
+	// Otherwise the movement component's wind channel pushes the capsule inside each move
 	if (DrawDebugStuff)
 	{
+		const FVector RidingWindForce = GetMyMovementComponent()->GetChannelForce(EALSForceChannel::Wind);
+		DrawDebugDirectionalArrow(GetWorld(), GridSample.Location, GridSample.Location + (RidingWindForce.GetSafeNormal() * 100.f), 50.f, FColor::Purple, false, .25f, 0, 5.f);
 		DrawDebugSphere
 		(
 			this->GetWorld(),
@@ -809,7 +778,7 @@ void AALSBaseCharacter::Tick(float DeltaTime)
 			0,
 			20.f
 		);
-		DrawDebugLine(this->GetWorld(), GetActorLocation(), GetActorLocation() + WindForce, FColor::Red, false, .01f, 0, 4.f);
+		DrawDebugLine(this->GetWorld(), GetActorLocation(), GetActorLocation() + WindFieldSample.SmoothedForce, FColor::Red, false, .01f, 0, 4.f);
 	}
 	
 	
@@ -827,7 +796,8 @@ void AALSBaseCharacter::Tick(float DeltaTime)
 		UpdateInAirRotation(DeltaTime);
 
 		// Perform a mantle check if falling while movement input is pressed.
-		if (bHasMovementInput)
+		// The server only mantles when a move from the owning client asks for it.
+		if (bHasMovementInput && IsLocallyControlled())
 		{
 			MantleCheck(FallingTraceSettings);
 		}
@@ -931,16 +901,32 @@ void AALSBaseCharacter::Server_SetMeshLocationDuringRagdoll_Implementation(FVect
 	TargetRagdollLocation = MeshLocation;
 }
 
-void AALSBaseCharacter::Server_SetPitchAndYaw_Implementation(float Yaw, float Pitch, FRotator SlerperRotation)
+void AALSBaseCharacter::ApplyMoveDesiredStates(EALSGait NewGait, EALSStance NewStance, EALSRotationMode NewRotMode)
 {
-	ReplicatedQuatYawRotation = SlerperRotation;
-	DeltaYaw = Yaw;
-	DeltaPitch = Pitch;
+	DesiredGait = NewGait;
+	DesiredStance = NewStance;
+	DesiredRotationMode = NewRotMode;
+
+	// Derive the walk speed the same way the client did before simulating this move
+	if (bDisableCurvedMovement)
+	{
+		UpdateDynamicMovementSettingsNetworked(GetAllowedGait());
+	}
+	else
+	{
+		UpdateDynamicMovementSettingsStandalone(GetAllowedGait());
+	}
 }
-void AALSBaseCharacter::Server_SetCameraRotation_Implementation(FRotator Rot)
+
+void AALSBaseCharacter::ApplyMoveAim(const FRotator& NewCameraRotation, const FRotator& NewCameraPollRotation)
 {
-	CameraRotation = Rot;
-	MyCharacterMovementComponent->GravityControlRotation(Rot);
+	CameraRotation = NewCameraRotation;
+	ReplicatedEssentials.QuatYawRotation = NewCameraPollRotation;
+	MyCharacterMovementComponent->GravityControlRotation(NewCameraRotation);
+
+	// Delta pitch and yaw are derived from the aim rather than sent
+	UpdateDeltaPitch();
+	UpdateDeltaYaw();
 }
 
 void AALSBaseCharacter::SetMovementState(const EALSMovementState NewState)
@@ -1000,45 +986,18 @@ void AALSBaseCharacter::SetGait(const EALSGait NewGait)
 
 void AALSBaseCharacter::SetDesiredStance(EALSStance NewStance)
 {
+	// Autonomous proxies hand the desired states to the server through their saved moves
 	DesiredStance = NewStance;
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredStance(NewStance);
-	}
-}
-
-void AALSBaseCharacter::Server_SetDesiredStance_Implementation(EALSStance NewStance)
-{
-	SetDesiredStance(NewStance);
 }
 
 void AALSBaseCharacter::SetDesiredGait(const EALSGait NewGait)
 {
 	DesiredGait = NewGait;
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredGait(NewGait);
-	}
-}
-
-void AALSBaseCharacter::Server_SetDesiredGait_Implementation(EALSGait NewGait)
-{
-	SetDesiredGait(NewGait);
 }
 
 void AALSBaseCharacter::SetDesiredRotationMode(EALSRotationMode NewRotMode)
 {
 	DesiredRotationMode = NewRotMode;
-
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		Server_SetDesiredRotationMode(NewRotMode);
-	}
-}
-
-void AALSBaseCharacter::Server_SetDesiredRotationMode_Implementation(EALSRotationMode NewRotMode)
-{
-	SetDesiredRotationMode(NewRotMode);
 }
 
 void AALSBaseCharacter::SetRotationMode(const EALSRotationMode NewRotationMode)
@@ -1141,23 +1100,6 @@ void AALSBaseCharacter::EventOnJumped()
 	MainAnimInstance->OnJumped();
 }
 
-void AALSBaseCharacter::Server_MantleStart_Implementation(float MantleHeight,
-                                                          const FALSComponentAndTransform& MantleLedgeWS,
-                                                          EALSMantleType MantleType)
-{
-	Multicast_MantleStart(MantleHeight, MantleLedgeWS, MantleType);
-}
-
-void AALSBaseCharacter::Multicast_MantleStart_Implementation(float MantleHeight,
-                                                             const FALSComponentAndTransform& MantleLedgeWS,
-                                                             EALSMantleType MantleType)
-{
-	if (!IsLocallyControlled())
-	{
-		MantleStart(MantleHeight, MantleLedgeWS, MantleType);
-	}
-}
-
 void AALSBaseCharacter::Server_PlayMontage_Implementation(UAnimMontage* montage, float track)
 {
 	Multicast_PlayMontage(montage, track);
@@ -1291,7 +1233,7 @@ bool AALSBaseCharacter::CanSprint() const
 
 	if (RotationMode == EALSRotationMode::LookingDirection)
 	{
-		const FRotator AccRot = ReplicatedCurrentAcceleration.ToOrientationRotator();
+		const FRotator AccRot = ReplicatedEssentials.CurrentAcceleration.ToOrientationRotator();
 		FRotator Delta = AccRot - AimingRotation;
 		Delta.Normalize();
 
@@ -1309,7 +1251,7 @@ void AALSBaseCharacter::SetIsMoving(bool bNewIsMoving)
 
 FVector AALSBaseCharacter::GetMovementInput() const
 {
-	return ReplicatedCurrentAcceleration;
+	return ReplicatedEssentials.CurrentAcceleration;
 }
 
 void AALSBaseCharacter::SetMovementInputAmount(float NewMovementInputAmount)
@@ -1492,7 +1434,7 @@ void AALSBaseCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, ui
 	{
 		SetMovementState(EALSMovementState::Grounded);
 	}
-	else if (GetCharacterMovement()->MovementMode == MOVE_Falling)
+	else if (GetCharacterMovement()->MovementMode == MOVE_Falling || GetMyMovementComponent()->IsInZeroGravity())
 	{
 		SetMovementState(EALSMovementState::InAir);
 	}
@@ -1519,8 +1461,8 @@ void AALSBaseCharacter::OnMovementStateChanged(const EALSMovementState PreviousS
 	}
 	else if (MovementState == EALSMovementState::Ragdoll && PreviousState == EALSMovementState::Mantling)
 	{
-		// Stop the Mantle Timeline if transitioning to the ragdoll state while mantling.
-		MantleTimeline->Stop();
+		// Stop the Mantle root motion if transitioning to the ragdoll state while mantling.
+		MyCharacterMovementComponent->StopMantleRootMotion();
 	}
 }
 
@@ -1636,18 +1578,14 @@ void AALSBaseCharacter::OnLandFrictionReset()
 void AALSBaseCharacter::SetEssentialValues(float DeltaTime)
 {
 
-	if (GetLocalRole() == ROLE_AutonomousProxy)
-	{
-		//Replicate the slerper and camera locations
-		Server_SetCameraRotation(FirstPersonCameraComponent->GetComponentRotation());
-		Server_SetPitchAndYaw(DeltaPitch, DeltaYaw, CameraPoll->GetComponentRotation());
-	}
+	// The slerper and camera rotations reach the server inside the movement saved moves
 	if (GetLocalRole() != ROLE_SimulatedProxy)
 	{
 		//CameraRotation = FirstPersonCameraComponent->GetComponentRotation();
-		ReplicatedCurrentAcceleration = GetCharacterMovement()->GetCurrentAcceleration();
-		ReplicatedControlRotation = GetControlRotation();
-		//ReplicatedQuatYawRotation = CameraPoll->GetComponentRotation();
+		ReplicatedEssentials.CurrentAcceleration = GetCharacterMovement()->GetCurrentAcceleration();
+		ReplicatedEssentials.ControlRotation = GetControlRotation();
+		ReplicatedEssentials.GravityDirection = GravityDirection;
+		//ReplicatedEssentials.QuatYawRotation = CameraPoll->GetComponentRotation();
 		EasedMaxAcceleration = GetCharacterMovement()->GetMaxAcceleration();
 	}
 
@@ -1662,15 +1600,15 @@ void AALSBaseCharacter::SetEssentialValues(float DeltaTime)
 		const FMatrix RotationMatrix = FRotationMatrix::MakeFromZX(CapsuleComponent->GetUpVector(), CameraPoll->GetForwardVector());
 		//LocalCorrectedRight = RotationMatrix.ToQuat().GetRightVector();
 
-		//ReplicatedQuatYawRotation = CameraPoll->GetComponentRotation();
-		ReplicatedQuatYawRotation = RotationMatrix.Rotator();
+		//ReplicatedEssentials.QuatYawRotation = CameraPoll->GetComponentRotation();
+		ReplicatedEssentials.QuatYawRotation = RotationMatrix.Rotator();
 		CameraRotation = FirstPersonCameraComponent->GetComponentRotation();
 	}
 
 	// Interp AimingRotation to current control rotation for smooth character rotation movement. Decrease InterpSpeed
 	// for slower but smoother movement.
-	AimingRotation = FMath::RInterpTo(AimingRotation, ReplicatedControlRotation, DeltaTime, 30);
-	QuatYawRotation = FMath::RInterpTo(QuatYawRotation, ReplicatedQuatYawRotation, DeltaTime, 30);
+	AimingRotation = FMath::RInterpTo(AimingRotation, ReplicatedEssentials.ControlRotation, DeltaTime, 30);
+	QuatYawRotation = FMath::RInterpTo(QuatYawRotation, ReplicatedEssentials.QuatYawRotation, DeltaTime, 30);
 	UpdateDeltaPitch();
 	UpdateDeltaYaw();
 	
@@ -1701,11 +1639,11 @@ void AALSBaseCharacter::SetEssentialValues(float DeltaTime)
 	// The Movement Input Amount is equal to the current acceleration divided by the max acceleration so that
 	// it has a range of 0-1, 1 being the maximum possible amount of input, and 0 being none.
 	// If the character has movement input, update the Last Movement Input Rotation.
-	SetMovementInputAmount(ReplicatedCurrentAcceleration.Size() / EasedMaxAcceleration);
+	SetMovementInputAmount(ReplicatedEssentials.CurrentAcceleration.Size() / EasedMaxAcceleration);
 	SetHasMovementInput(MovementInputAmount > 0.0f);
 	if (bHasMovementInput)
 	{
-		LastMovementInputRotation = ReplicatedCurrentAcceleration.ToOrientationRotator();
+		LastMovementInputRotation = ReplicatedEssentials.CurrentAcceleration.ToOrientationRotator();
 	}
 
 	// Set the Aim Yaw rate by comparing the current and previous Aim Yaw value, divided by Delta Seconds.
@@ -1766,7 +1704,7 @@ void AALSBaseCharacter::UpdateDynamicMovementSettingsNetworked(EALSGait AllowedG
 	// Update the Character Max Walk Speed to the configured speeds based on the currently Allowed Gait.
 	if (IsLocallyControlled() || HasAuthority())
 	{
-		if (GetCharacterMovement()->MaxWalkSpeed != NewMaxSpeed)
+		if (MyCharacterMovementComponent->MyNewMaxWalkSpeed != NewMaxSpeed)
 		{
 			MyCharacterMovementComponent->SetMaxWalkingSpeed(NewMaxSpeed);
 		}
@@ -1822,7 +1760,7 @@ void AALSBaseCharacter::UpdateGroundedRotation(float DeltaTime)
 				FQuat DeltaQuatYaw = FRotator(0.f, YawValue, 0.f).Quaternion();
 				const FMatrix RotationMatrix = FRotationMatrix::MakeFromZX(CapsuleComponent->GetUpVector(), CameraPoll->GetForwardVector());
 				FRotator OutRotation = (RotationMatrix.ToQuat() * DeltaQuatYaw).Rotator();
-				SmoothCharacterRotationYaw(1.f, ReplicatedQuatYawRotation, 500.f, GroundedRotationRate, DeltaTime);
+				SmoothCharacterRotationYaw(1.f, ReplicatedEssentials.QuatYawRotation, 500.f, GroundedRotationRate, DeltaTime);
 			}
 			else if (RotationMode == EALSRotationMode::Aiming)
 			{
@@ -1862,7 +1800,7 @@ void AALSBaseCharacter::UpdateGroundedRotation(float DeltaTime)
 				}
 				else if (GetLocalRole() == ROLE_SimulatedProxy)
 				{
-					//UE_LOG(LogTemp, Log, TEXT("ROLE_SimulatedProxy: ReplicatedQuatYawRotation: %s"), *ReplicatedQuatYawRotation.ToString());
+					//UE_LOG(LogTemp, Log, TEXT("ROLE_SimulatedProxy: ReplicatedEssentials.QuatYawRotation: %s"), *ReplicatedEssentials.QuatYawRotation.ToString());
 					AddActorLocalRotation(DeltaQuatYaw);
 				}
 				else if (IsLocallyControlled())
@@ -1943,19 +1881,30 @@ void AALSBaseCharacter::MantleStart(float MantleHeight, const FALSComponentAndTr
 	                             FVector::OneVector);
 	MantleAnimatedStartOffset = UALSMathLibrary::TransfromSub(StartOffset, MantleTarget);
 
-	// Step 5: Clear the Character Movement Mode and set the Movement State to Mantling
-	GetCharacterMovement()->SetMovementMode(MOVE_None);
+	// Step 5: Hand the mantle to the movement component as a root motion source, so the owning client predicts it
+	// and the server replays it with the move. Simulated proxies follow the replicated movement instead.
+	if (GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		const TSharedPtr<FALSRootMotionSource_Mantle> MantleSource = MakeShared<FALSRootMotionSource_Mantle>();
+		MantleSource->MantleParams = MantleParams;
+		MantleSource->BlendInCurve = MantleTimelineCurve;
+		MantleSource->MantleLedgeLS = MantleLedgeLS;
+		MantleSource->MantleActualStartOffset = MantleActualStartOffset;
+		MantleSource->MantleAnimatedStartOffset = MantleAnimatedStartOffset;
+		MantleSource->InitDuration();
+		MyCharacterMovementComponent->ApplyMantleRootMotion(MantleSource);
+	}
+
+	// Step 6: Set the Movement State to Mantling and let simulated proxies know about it.
 	SetMovementState(EALSMovementState::Mantling);
 
-	// Step 6: Configure the Mantle Timeline so that it is the same length as the
-	// Lerp/Correction curve minus the starting position, and plays at the same speed as the animation.
-	// Then start the timeline.
-	float MinTime = 0.0f;
-	float MaxTime = 0.0f;
-	MantleParams.PositionCorrectionCurve->GetTimeRange(MinTime, MaxTime);
-	MantleTimeline->SetTimelineLength(MaxTime - MantleParams.StartingPosition);
-	MantleTimeline->SetPlayRate(MantleParams.PlayRate);
-	MantleTimeline->PlayFromStart();
+	if (HasAuthority())
+	{
+		ReplicatedMantle.MantleHeight = MantleHeight;
+		ReplicatedMantle.MantleLedgeWS = MantleLedgeWS;
+		ReplicatedMantle.MantleType = MantleType;
+		ReplicatedMantle.MantleCount++;
+	}
 
 	// Step 7: Play the Anim Montaget if valid.
 	if (IsValid(MantleParams.AnimMontage))
@@ -1968,10 +1917,11 @@ void AALSBaseCharacter::MantleStart(float MantleHeight, const FALSComponentAndTr
 bool AALSBaseCharacter::MantleCheck(const FALSMantleTraceSettings& TraceSettings, EDrawDebugTrace::Type DebugType)
 {
 	// Step 1: Trace forward to find a wall / object the character cannot walk on.
+	const FVector MantleDirection = GetMantleDirection();
 	const FVector& CapsuleBaseLocation = UALSMathLibrary::GetCapsuleBaseLocation(2.0f, CapsuleComponent);
-	FVector TraceStart = CapsuleBaseLocation + GetPlayerMovementInput() * -30.0f;
+	FVector TraceStart = CapsuleBaseLocation + MantleDirection * -30.0f;
 	TraceStart.Z += (TraceSettings.MaxLedgeHeight + TraceSettings.MinLedgeHeight) / 2.0f;
-	const FVector TraceEnd = TraceStart + (GetPlayerMovementInput() * TraceSettings.ReachDistance);
+	const FVector TraceEnd = TraceStart + (MantleDirection * TraceSettings.ReachDistance);
 	const float HalfHeight = 1.0f + ((TraceSettings.MaxLedgeHeight - TraceSettings.MinLedgeHeight) / 2.0f);
 
 	UWorld* World = GetWorld();
@@ -2061,71 +2011,40 @@ bool AALSBaseCharacter::MantleCheck(const FALSMantleTraceSettings& TraceSettings
 	MantleWS.Component = HitComponent;
 	MantleWS.Transform = TargetTransform;
 	MantleStart(MantleHeight, MantleWS, MantleType);
-	Server_MantleStart(MantleHeight, MantleWS, MantleType);
 
 	return true;
 }
 
-// This function is called by "MantleTimeline" using BindUFunction in the AALSBaseCharacter::BeginPlay during the default settings initalization.
-void AALSBaseCharacter::MantleUpdate(float BlendIn)
-{
-	// Step 1: Continually update the mantle target from the stored local transform to follow along with moving objects
-	MantleTarget = UALSMathLibrary::MantleComponentLocalToWorld(MantleLedgeLS);
-
-	// Step 2: Update the Position and Correction Alphas using the Position/Correction curve set for each Mantle.
-	const FVector CurveVec = MantleParams.PositionCorrectionCurve
-	                                     ->GetVectorValue(
-		                                     MantleParams.StartingPosition + MantleTimeline->GetPlaybackPosition());
-	const float PositionAlpha = CurveVec.X;
-	const float XYCorrectionAlpha = CurveVec.Y;
-	const float ZCorrectionAlpha = CurveVec.Z;
-
-	// Step 3: Lerp multiple transforms together for independent control over the horizontal
-	// and vertical blend to the animated start position, as well as the target position.
-
-	// Blend into the animated horizontal and rotation offset using the Y value of the Position/Correction Curve.
-	const FTransform TargetHzTransform(MantleAnimatedStartOffset.GetRotation(),
-	                                   {
-		                                   MantleAnimatedStartOffset.GetLocation().X,
-		                                   MantleAnimatedStartOffset.GetLocation().Y,
-		                                   MantleActualStartOffset.GetLocation().Z
-	                                   },
-	                                   FVector::OneVector);
-	const FTransform& HzLerpResult =
-		UKismetMathLibrary::TLerp(MantleActualStartOffset, TargetHzTransform, XYCorrectionAlpha);
-
-	// Blend into the animated vertical offset using the Z value of the Position/Correction Curve.
-	const FTransform TargetVtTransform(MantleActualStartOffset.GetRotation(),
-	                                   {
-		                                   MantleActualStartOffset.GetLocation().X,
-		                                   MantleActualStartOffset.GetLocation().Y,
-		                                   MantleAnimatedStartOffset.GetLocation().Z
-	                                   },
-	                                   FVector::OneVector);
-	const FTransform& VtLerpResult =
-		UKismetMathLibrary::TLerp(MantleActualStartOffset, TargetVtTransform, ZCorrectionAlpha);
-
-	const FTransform ResultTransform(HzLerpResult.GetRotation(),
-	                                 {
-		                                 HzLerpResult.GetLocation().X, HzLerpResult.GetLocation().Y,
-		                                 VtLerpResult.GetLocation().Z
-	                                 },
-	                                 FVector::OneVector);
-
-	// Blend from the currently blending transforms into the final mantle target using the X
-	// value of the Position/Correction Curve.
-	const FTransform& ResultLerp = UKismetMathLibrary::TLerp(
-		UALSMathLibrary::TransfromAdd(MantleTarget, ResultTransform), MantleTarget,
-		PositionAlpha);
-
-	// Initial Blend In (controlled in the timeline curve) to allow the actor to blend into the Position/Correction
-	// curve at the midoint. This prevents pops when mantling an object lower than the animated mantle.
-	const FTransform& LerpedTarget =
-		UKismetMathLibrary::TLerp(UALSMathLibrary::TransfromAdd(MantleTarget, MantleActualStartOffset), ResultLerp,
-		                          BlendIn);
-
-	// Step 4: Set the actors location and rotation to the Lerped Target.
-	SetActorLocationAndTargetRotation(LerpedTarget.GetLocation(), LerpedTarget.GetRotation().Rotator());
+bool AALSBaseCharacter::MantleCheckFromMove()
+{
+	if (MovementState == EALSMovementState::Mantling)
+	{
+		return true;
+	}
+
+	// Same trace settings the owning client picked from its movement state
+	const FALSMantleTraceSettings& TraceSettings =
+		MovementState == EALSMovementState::InAir ? FallingTraceSettings : GroundedTraceSettings;
+	return MantleCheck(TraceSettings, EDrawDebugTrace::Type::None);
+}
+
+void AALSBaseCharacter::MantleRootMotionFinished()
+{
+	if (MovementState == EALSMovementState::Mantling)
+	{
+		MantleEnd();
+	}
+}
+
+FVector AALSBaseCharacter::GetMantleDirection() const
+{
+	if (IsLocallyControlled())
+	{
+		return GetPlayerMovementInput();
+	}
+
+	// Input axes only exist on the owning client, the acceleration from its move points the same way
+	return GetCharacterMovement()->GetCurrentAcceleration().GetSafeNormal();
 }
 
 void AALSBaseCharacter::MantleEnd()
@@ -2390,7 +2309,7 @@ void AALSBaseCharacter::PlayerForwardMovementInput(float Value)
 FVector AALSBaseCharacter::GetReplicatedForward()
 {
 	
-return UKismetMathLibrary::GetForwardVector(ReplicatedControlRotation);
+return UKismetMathLibrary::GetForwardVector(ReplicatedEssentials.ControlRotation);
 }
 
 void AALSBaseCharacter::PlayerRightMovementInput(float Value)
@@ -2938,11 +2857,19 @@ void AALSBaseCharacter::OnRep_OverlayState(EALSOverlayState PrevOverlayState)
 	OnOverlayStateChanged(PrevOverlayState);
 }
 
+void AALSBaseCharacter::OnRep_ReplicatedMantle()
+{
+	// Owner and server started this mantle themselves, simulated proxies only need the montage and the state
+	if (GetLocalRole() == ROLE_SimulatedProxy && ReplicatedMantle.MantleLedgeWS.Component)
+	{
+		MantleStart(ReplicatedMantle.MantleHeight, ReplicatedMantle.MantleLedgeWS, ReplicatedMantle.MantleType);
+	}
+}
+
 void AALSBaseCharacter::ReturnToGravity()
 {
-	if (GetCharacterMovement()->MovementMode == EMovementMode::MOVE_Flying)
+	if (GetMyMovementComponent()->IsInZeroGravity())
 	{
-		GetMyMovementComponent()->ForceZeroG = false;
 		GetCharacterMovement()->SetMovementMode(MOVE_Falling);
 		SetMovementState(EALSMovementState::Grounded);
 		UE_LOG(LogTemp, Log, TEXT("ReturnToGravity"));
@@ -2952,9 +2879,7 @@ void AALSBaseCharacter::ReturnToGravity()
 void AALSBaseCharacter::ZeroGravTest()
 {
 	//UE_LOG(LogTemp, Log, TEXT("ZeroGravTest"));
-	GetMyMovementComponent()->ForceZeroG = true;
-	GetCharacterMovement()->SetMovementMode(MOVE_Flying);
-	SetMovementState(EALSMovementState::InAir);
+	GetCharacterMovement()->SetMovementMode(MOVE_Custom, static_cast<uint8>(EALSCustomMovementMode::ZeroGravity));
 	
 	
 
@@ -2981,8 +2906,8 @@ void AALSBaseCharacter::UpdateDeltaPitch()
 {
 
 	
-		FVector PitchForward = UKismetMathLibrary::GetForwardVector(ReplicatedControlRotation);
-		FVector SlerperForward = UKismetMathLibrary::GetForwardVector(ReplicatedQuatYawRotation);
+		FVector PitchForward = UKismetMathLibrary::GetForwardVector(ReplicatedEssentials.ControlRotation);
+		FVector SlerperForward = UKismetMathLibrary::GetForwardVector(ReplicatedEssentials.QuatYawRotation);
 		FVector CharacterUp = GetActorUpVector();
 		float DeltaQuatDot = FVector::DotProduct(PitchForward, SlerperForward);
 		float DeltaQuatAcos = FMath::Acos(DeltaQuatDot);
@@ -3003,7 +2928,7 @@ void AALSBaseCharacter::UpdateDeltaYaw()
 {
 
 	
-	FVector YawForward = UKismetMathLibrary::GetForwardVector(ReplicatedQuatYawRotation);
+	FVector YawForward = UKismetMathLibrary::GetForwardVector(ReplicatedEssentials.QuatYawRotation);
 	FVector CharacterForward = GetActorForwardVector();
 	FVector CharacterRight = GetActorRightVector();
 	float DeltaQuatDot = FVector::DotProduct(YawForward, CharacterForward);
@@ -9,14 +9,34 @@
 #include "GameFramework/PhysicsVolume.h"
 #include "GameFramework/Character.h"
 #include "Components/CapsuleComponent.h"
+#include "Camera/PlayerCameraManager.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "DrawDebugHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/NetworkObjectList.h"
+#include "UObject/UObjectIterator.h"
 #include "Character/ALSBaseCharacter.h"
+#include "Character/ALSRootMotionSource_Mantle.h"
+#include "Character/ALSGravityFrame.h"
+#include "Character/ALSGravityFieldSubsystem.h"
+#include "Character/ALSMovementQuerySubsystem.h"
+#include "Character/ALSRotatingBaseComponent.h"
+#include "Character/ALSWindFieldSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("PerformMovement (World Gravity)"), STAT_ALSPerformMovementWorldGravity, STATGROUP_ALSMovement);
+DECLARE_CYCLE_STAT(TEXT("PerformMovement (Custom Gravity)"), STAT_ALSPerformMovementCustomGravity, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Cache Hits"), STAT_ALSFloorCacheHits, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floor Cache Misses"), STAT_ALSFloorCacheMisses, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Floor Probes Used"), STAT_ALSAsyncFloorProbesUsed, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Floor Probes Rejected"), STAT_ALSAsyncFloorProbesRejected, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Ledge Probes Used"), STAT_ALSAsyncLedgeProbesUsed, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Ledge Probes Requested"), STAT_ALSAsyncLedgeProbesRequested, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Ledge Probes Skipped"), STAT_ALSAsyncLedgeProbesSkipped, STATGROUP_ALSMovement);
 
 const float VERTICAL_SLOPE_NORMAL_Z = 0.001f; // Slope is vertical if Abs(Normal.Z) <= this threshold. Accounts for precision problems that sometimes angle normals slightly off horizontal for vertical surface.
 const float MAX_STEP_SIDE_Z = 0.08f;	// maximum z value for the normal on the vertical side of steps
+const float MOVEMENT_LOD_EVALUATE_INTERVAL = 0.25f; // seconds between movement LOD evaluations of a simulated proxy
+const float WORLD_GRAVITY_FRAME_MIN_UP_Z = 1.0f - 1.e-6f; // capsule up Z above which the capsule counts as upright for the world gravity frame
 
 // CVars
 namespace CharacterMovementCVars
@@ -99,6 +119,51 @@ namespace CharacterMovementCVars
 		TEXT("Tolerance for relative rotation attachment change when combining moves. Small tolerances allow for very slight jitter due to transform updates."),
 		ECVF_Default);
 
+	static float NetMoveCombiningGravityDirectionTolerance = 0.001f;
+	FAutoConsoleVariableRef CVarNetMoveCombiningGravityDirectionTolerance(
+		TEXT("p.NetMoveCombiningGravityDirectionTolerance"),
+		NetMoveCombiningGravityDirectionTolerance,
+		TEXT("Per-component tolerance for gravity direction change when combining moves. Moves simulated under different gravity are never combined."),
+		ECVF_Default);
+
+	static float NetMoveGravityDirectionTolerance = 0.02f;
+	FAutoConsoleVariableRef CVarNetMoveGravityDirectionTolerance(
+		TEXT("p.NetMoveGravityDirectionTolerance"),
+		NetMoveGravityDirectionTolerance,
+		TEXT("Per-component tolerance within which the server simulates a client move under the gravity direction the client sent.\n")
+		TEXT("Moves further off are simulated under the server's gravity and the client is corrected."),
+		ECVF_Default);
+
+	static float NetMoveGravityScaleTolerance = 0.02f;
+	FAutoConsoleVariableRef CVarNetMoveGravityScaleTolerance(
+		TEXT("p.NetMoveGravityScaleTolerance"),
+		NetMoveGravityScaleTolerance,
+		TEXT("Tolerance within which the server simulates a client move under the gravity scale the client sent.\n")
+		TEXT("Moves further off are simulated under the server's gravity and the client is corrected."),
+		ECVF_Default);
+
+	static float NetMoveFixedStepForceTolerance = 1.0f;
+	FAutoConsoleVariableRef CVarNetMoveFixedStepForceTolerance(
+		TEXT("p.NetMoveFixedStepForceTolerance"),
+		NetMoveFixedStepForceTolerance,
+		TEXT("Tolerance, per axis in force times seconds, within which the server starts a client move from the force the client\n")
+		TEXT("carried over from its last fixed step. Further off, the server keeps its own carry-over and the client is corrected."),
+		ECVF_Default);
+
+	static float NetMoveAimSendThreshold = 0.5f;
+	FAutoConsoleVariableRef CVarNetMoveAimSendThreshold(
+		TEXT("p.NetMoveAimSendThreshold"),
+		NetMoveAimSendThreshold,
+		TEXT("Change in degrees of the camera or camera poll rotation needed before the aim is written into the next client move."),
+		ECVF_Default);
+
+	static float NetMoveAimRefreshInterval = 0.25f;
+	FAutoConsoleVariableRef CVarNetMoveAimRefreshInterval(
+		TEXT("p.NetMoveAimRefreshInterval"),
+		NetMoveAimRefreshInterval,
+		TEXT("Max time in seconds between aim updates in client moves, so a dropped move can't leave the server with a stale aim."),
+		ECVF_Default);
+
 	static float NetStationaryRotationTolerance = 0.1f;
 	FAutoConsoleVariableRef CVarNetStationaryRotationTolerance(
 		TEXT("p.NetStationaryRotationTolerance"),
@@ -143,6 +208,126 @@ namespace CharacterMovementCVars
 		TEXT("If 1, force a jump substep to always reach the peak position of a jump, which can often be cut off as framerate lowers."),
 		ECVF_Default);
 
+	static int32 UseWorldGravityFrame = 1;
+	FAutoConsoleVariableRef CVarUseWorldGravityFrame(
+		TEXT("p.ALSUseWorldGravityFrame"),
+		UseWorldGravityFrame,
+		TEXT("Whether world down gravity on an upright capsule takes the specialized movement paths that skip the arbitrary axis math.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 FloorCacheEnabled = 1;
+	FAutoConsoleVariableRef CVarFloorCacheEnabled(
+		TEXT("p.ALSFloorCache"),
+		FloorCacheEnabled,
+		TEXT("Whether FindFloor reuses its last result while the capsule, its floor and gravity haven't changed.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static float FloorCacheTolerance = 1.0f;
+	FAutoConsoleVariableRef CVarFloorCacheTolerance(
+		TEXT("p.ALSFloorCacheTolerance"),
+		FloorCacheTolerance,
+		TEXT("Distance the capsule can move relative to a flat floor before the cached floor is swept again."),
+		ECVF_Default);
+
+	static float FloorCacheMaxAge = 0.5f;
+	FAutoConsoleVariableRef CVarFloorCacheMaxAge(
+		TEXT("p.ALSFloorCacheMaxAge"),
+		FloorCacheMaxAge,
+		TEXT("Seconds a cached floor is trusted before sweeping again, to pick up geometry that moved in under the capsule."),
+		ECVF_Default);
+
+	static int32 AsyncMovementQueries = 1;
+	FAutoConsoleVariableRef CVarAsyncMovementQueries(
+		TEXT("p.ALSAsyncMovementQueries"),
+		AsyncMovementQueries,
+		TEXT("Whether AI characters with bUseAsyncMovementQueries use async floor and ledge sweeps from the previous frame.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static float AsyncMovementQueryTolerance = 4.0f;
+	FAutoConsoleVariableRef CVarAsyncMovementQueryTolerance(
+		TEXT("p.ALSAsyncMovementQueryTolerance"),
+		AsyncMovementQueryTolerance,
+		TEXT("Distance between where an async floor or ledge sweep was issued from and where it is used, beyond which it is swept again synchronously."),
+		ECVF_Default);
+
+	static int32 EnableMovementLOD = 1;
+	FAutoConsoleVariableRef CVarMovementLOD(
+		TEXT("p.ALSMovementLOD"),
+		EnableMovementLOD,
+		TEXT("Whether simulated proxies reduce their movement simulation with distance and visibility.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static float MovementLODReducedDistance = 2500.0f;
+	FAutoConsoleVariableRef CVarMovementLODReducedDistance(
+		TEXT("p.ALSMovementLOD.ReducedDistance"),
+		MovementLODReducedDistance,
+		TEXT("Distance to the closest local view from which simulated proxies only run the full simulation every p.ALSMovementLOD.ReducedInterval."),
+		ECVF_Default);
+
+	static float MovementLODMinimalDistance = 6000.0f;
+	FAutoConsoleVariableRef CVarMovementLODMinimalDistance(
+		TEXT("p.ALSMovementLOD.MinimalDistance"),
+		MovementLODMinimalDistance,
+		TEXT("Distance to the closest local view from which simulated proxies skip simulation and floor checks and follow replicated movement."),
+		ECVF_Default);
+
+	static float MovementLODReducedInterval = 0.1f;
+	FAutoConsoleVariableRef CVarMovementLODReducedInterval(
+		TEXT("p.ALSMovementLOD.ReducedInterval"),
+		MovementLODReducedInterval,
+		TEXT("Seconds between full simulation steps of reduced LOD proxies, they extrapolate along their velocity with a single sweep in between."),
+		ECVF_Default);
+
+	static float MovementLODNotRenderedTime = 0.5f;
+	FAutoConsoleVariableRef CVarMovementLODNotRenderedTime(
+		TEXT("p.ALSMovementLOD.NotRenderedTime"),
+		MovementLODNotRenderedTime,
+		TEXT("Proxies whose mesh wasn't rendered for this long, off screen or occluded, drop one movement LOD further. 0 disables the check."),
+		ECVF_Default);
+
+	static int32 MovementLODDebug = 0;
+	FAutoConsoleVariableRef CVarMovementLODDebug(
+		TEXT("p.ALSMovementLOD.Debug"),
+		MovementLODDebug,
+		TEXT("Draw the movement LOD above simulated proxies.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Cheat);
+
+	static int32 RotatingBaseFastPath = 1;
+	FAutoConsoleVariableRef CVarRotatingBaseFastPath(
+		TEXT("p.ALSRotatingBaseFastPath"),
+		RotatingBaseFastPath,
+		TEXT("Whether characters on a base with a UALSRotatingBaseComponent follow its spin analytically instead of through the base transform.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 CentrifugalGravity = 1;
+	FAutoConsoleVariableRef CVarCentrifugalGravity(
+		TEXT("p.ALSCentrifugalGravity"),
+		CentrifugalGravity,
+		TEXT("Whether rotating bases with bCentrifugalGravity set the gravity of the characters on them.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 AnalyticFalling = 1;
+	FAutoConsoleVariableRef CVarAnalyticFalling(
+		TEXT("p.ALSAnalyticFalling"),
+		AnalyticFalling,
+		TEXT("Whether falling without air control moves along the exact arc of gravity and external forces in one iteration instead of fixed time steps.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static float FallingArcTolerance = 2.0f;
+	FAutoConsoleVariableRef CVarFallingArcTolerance(
+		TEXT("p.ALSFallingArcTolerance"),
+		FallingArcTolerance,
+		TEXT("Largest distance between a falling arc and the straight sweeps it is followed with."),
+		ECVF_Default);
+
 	static float NetServerMoveTimestampExpiredWarningThreshold = 1.0f;
 	FAutoConsoleVariableRef CVarNetServerMoveTimestampExpiredWarningThreshold(
 		TEXT("net.NetServerMoveTimestampExpiredWarningThreshold"),
@@ -249,6 +434,7 @@ FORCEINLINE FVector GetClampedToMaxSizePrecise(const FVector& V, float MaxSize)
 UALSCharacterMovementComponent::UALSCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	SetNetworkMoveDataContainer(ALSNetworkMoveDataContainer);
 }
 
 void UALSCharacterMovementComponent::OnMovementUpdated(float DeltaTime, const FVector& OldLocation, const FVector& OldVelocity)
@@ -271,6 +457,28 @@ void UALSCharacterMovementComponent::OnMovementUpdated(float DeltaTime, const FV
 
 
 	}
+
+	// The mantle start has been captured by this move, don't send it again with the next one
+	if (CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy && !CharacterOwner->bClientUpdating)
+	{
+		bWantsToMantle = false;
+	}
+
+	// Finish the mantle once its root motion source ran out, on replays as well as on live moves
+	if (MantleRootMotionSourceID != (uint16)ERootMotionSourceID::Invalid)
+	{
+		const TSharedPtr<FRootMotionSource> MantleSource = GetRootMotionSourceByID(MantleRootMotionSourceID);
+		if (!MantleSource.IsValid() || MantleSource->Status.HasFlag(ERootMotionSourceStatusFlags::Finished))
+		{
+			StopMantleRootMotion();
+
+			AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(CharacterOwner);
+			if (Character)
+			{
+				Character->MantleRootMotionFinished();
+			}
+		}
+	}
 }
 
 void UALSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags) // Client only
@@ -278,6 +486,140 @@ void UALSCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags) // C
 	Super::UpdateFromCompressedFlags(Flags);
 
 	bRequestMovementSettingsChange = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToMantle = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+}
+
+void UALSCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) // Server only
+{
+	const FALSCharacterNetworkMoveData* MoveData = static_cast<const FALSCharacterNetworkMoveData*>(GetCurrentNetworkMoveData());
+	if (!MoveData)
+	{
+		Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+		return;
+	}
+
+	AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(CharacterOwner);
+	if (Character)
+	{
+		if (MoveData->bHasAim)
+		{
+			Character->ApplyMoveAim(MoveData->CameraRotation, MoveData->CameraPollRotation);
+		}
+
+		// Two bits hold one more rotation mode than there is. A move carrying a value past the last enumerator is
+		// malformed, keep the desired states we have rather than casting it into the enum
+		const bool bValidDesiredStates =
+			MoveData->DesiredGait <= static_cast<uint8>(EALSGait::Sliding) &&
+			MoveData->DesiredStance <= static_cast<uint8>(EALSStance::Crouching) &&
+			MoveData->DesiredRotationMode <= static_cast<uint8>(EALSRotationMode::Aiming);
+		if (bValidDesiredStates)
+		{
+			Character->ApplyMoveDesiredStates(static_cast<EALSGait>(MoveData->DesiredGait),
+			                                  static_cast<EALSStance>(MoveData->DesiredStance),
+			                                  static_cast<EALSRotationMode>(MoveData->DesiredRotationMode));
+		}
+	}
+
+	// The server's gravity is authoritative. The client's is only taken when it is within tolerance, to absorb
+	// quantization and the frame the two sides cross a gravity field boundary on. Anything else is corrected
+	const FVector ServerGravityDirection = CustomGravityDirection;
+	const float ServerGravityScale = GravityScale;
+
+	const bool bClientGravityAccepted =
+		MoveData->GravityDirection.Equals(ServerGravityDirection, CharacterMovementCVars::NetMoveGravityDirectionTolerance) &&
+		FMath::IsNearlyEqual(MoveData->GravityScale, ServerGravityScale, CharacterMovementCVars::NetMoveGravityScaleTolerance);
+
+	// Start from the client's fixed timestep remainder, so the same move delta runs the same substeps on both sides.
+	// It is bounded by one substep, and move deltas the server clamps or merges still diverge and get corrected
+	if (bUseFixedTimestep && FixedTimestep > 0.0f)
+	{
+		FixedStepTime = FMath::Clamp(MoveData->FixedStepTime, 0.0f, FixedTimestep);
+
+		// The force carried over with the remainder too, as long as it is what the server's own forces allow
+		if (FixedStepTime == 0.0f)
+		{
+			FixedStepForceTime = FVector::ZeroVector;
+		}
+		else if (!MoveData->FixedStepForceTime.ContainsNaN() &&
+			MoveData->FixedStepForceTime.Equals(FixedStepForceTime, CharacterMovementCVars::NetMoveFixedStepForceTolerance))
+		{
+			FixedStepForceTime = MoveData->FixedStepForceTime;
+		}
+	}
+
+	if (bClientGravityAccepted)
+	{
+		ApplyMoveGravity(MoveData->GravityDirection, MoveData->GravityScale);
+	}
+	else if (FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character())
+	{
+		ServerData->bForceClientUpdate = true;
+	}
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+	ApplyMoveGravity(ServerGravityDirection, ServerGravityScale);
+}
+
+bool UALSCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	// Replayed moves restore their own gravity and walk speed, the live values must survive the replay
+	const FVector CurrentGravityDirection = CustomGravityDirection;
+	const float CurrentGravityScale = GravityScale;
+	const float CurrentMaxWalkSpeed = MyNewMaxWalkSpeed;
+
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	ApplyMoveGravity(CurrentGravityDirection, CurrentGravityScale);
+	MyNewMaxWalkSpeed = CurrentMaxWalkSpeed;
+	return bResult;
+}
+
+void UALSCharacterMovementComponent::ApplyMoveGravity(const FVector& NewGravityDirection, float NewGravityScale)
+{
+	CustomGravityDirection = NewGravityDirection;
+	GravityScale = NewGravityScale;
+}
+
+void UALSCharacterMovementComponent::ApplyMantleRootMotion(TSharedPtr<FALSRootMotionSource_Mantle> MantleSource)
+{
+	StopMantleRootMotion();
+
+	// Flying lets the override velocity move the capsule freely while still sweeping against the world
+	SetMovementMode(MOVE_Flying);
+	MantleRootMotionSourceID = ApplyRootMotionSource(MantleSource);
+
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		bWantsToMantle = true;
+	}
+}
+
+void UALSCharacterMovementComponent::StopMantleRootMotion()
+{
+	if (MantleRootMotionSourceID != (uint16)ERootMotionSourceID::Invalid)
+	{
+		RemoveRootMotionSourceByID(MantleRootMotionSourceID);
+		MantleRootMotionSourceID = (uint16)ERootMotionSourceID::Invalid;
+	}
+}
+
+bool UALSCharacterMovementComponent::ShouldSendMoveAim(const FRotator& CameraRotation, const FRotator& CameraPollRotation)
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	const float Threshold = CharacterMovementCVars::NetMoveAimSendThreshold;
+
+	if (LastSentAimTime >= 0.f &&
+		CurrentTime - LastSentAimTime < CharacterMovementCVars::NetMoveAimRefreshInterval &&
+		CameraRotation.Equals(LastSentCameraRotation, Threshold) &&
+		CameraPollRotation.Equals(LastSentCameraPollRotation, Threshold))
+	{
+		return false;
+	}
+
+	LastSentCameraRotation = CameraRotation;
+	LastSentCameraPollRotation = CameraPollRotation;
+	LastSentAimTime = CurrentTime;
+	return true;
 }
 
 class FNetworkPredictionData_Client* UALSCharacterMovementComponent::GetPredictionData_Client() const
@@ -301,6 +643,18 @@ void UALSCharacterMovementComponent::FSavedMove_My::Clear()
 	Super::Clear();
 
 	bSavedRequestMovementSettingsChange = false;
+	bSavedWantsToMantle = false;
+	SavedGravityDirection = FVector::DownVector;
+	SavedGravityScale = 1.f;
+	SavedFixedStepTime = 0.f;
+	SavedFixedStepForceTime = FVector::ZeroVector;
+	SavedSmoothedWindForce = FVector::ZeroVector;
+	SavedCameraRotation = FRotator::ZeroRotator;
+	SavedCameraPollRotation = FRotator::ZeroRotator;
+	SavedDesiredGait = EALSGait::Walking;
+	SavedDesiredStance = EALSStance::Standing;
+	SavedDesiredRotationMode = EALSRotationMode::VelocityDirection;
+	SavedMaxWalkSpeed = 0.f;
 }
 
 uint8 UALSCharacterMovementComponent::FSavedMove_My::GetCompressedFlags() const
@@ -312,6 +666,11 @@ uint8 UALSCharacterMovementComponent::FSavedMove_My::GetCompressedFlags() const
 		Result |= FLAG_Custom_0;
 	}
 
+	if (bSavedWantsToMantle)
+	{
+		Result |= FLAG_Custom_1;
+	}
+
 	return Result;
 }
 
@@ -324,9 +683,198 @@ void UALSCharacterMovementComponent::FSavedMove_My::SetMoveFor(ACharacter* Chara
 	if (CharacterMovement)
 	{
 		bSavedRequestMovementSettingsChange = CharacterMovement->bRequestMovementSettingsChange;
+		bSavedWantsToMantle = CharacterMovement->bWantsToMantle;
+		SavedGravityDirection = CharacterMovement->CustomGravityDirection;
+		SavedGravityScale = CharacterMovement->GravityScale;
+		SavedFixedStepTime = CharacterMovement->FixedStepTime;
+		SavedFixedStepForceTime = CharacterMovement->FixedStepForceTime;
+		SavedSmoothedWindForce = CharacterMovement->SmoothedWindForce;
+		SavedMaxWalkSpeed = CharacterMovement->MyNewMaxWalkSpeed;
+	}
+
+	AALSBaseCharacter* ALSCharacter = Cast<AALSBaseCharacter>(Character);
+	if (ALSCharacter)
+	{
+		SavedCameraRotation = ALSCharacter->GetFirstPersonCameraRotation();
+		SavedCameraPollRotation = ALSCharacter->GetCameraPoll()->GetComponentRotation();
+		SavedDesiredGait = ALSCharacter->GetDesiredGait();
+		SavedDesiredStance = ALSCharacter->GetDesiredStance();
+		SavedDesiredRotationMode = ALSCharacter->GetDesiredRotationMode();
 	}
 }
 
+bool UALSCharacterMovementComponent::FSavedMove_My::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_My* MyNewMove = static_cast<const FSavedMove_My*>(NewMove.Get());
+
+	// Moves sharing a gravity frame combine as usual, a gravity transition always starts a new move
+	if (!SavedGravityDirection.Equals(MyNewMove->SavedGravityDirection, CharacterMovementCVars::NetMoveCombiningGravityDirectionTolerance))
+	{
+		return false;
+	}
+
+	if (SavedGravityScale != MyNewMove->SavedGravityScale)
+	{
+		return false;
+	}
+
+	// The server has to see the mantle start on the exact move it was predicted in
+	if (bSavedWantsToMantle || MyNewMove->bSavedWantsToMantle)
+	{
+		return false;
+	}
+
+	// A desired state change alters the walk speed, so it can't be folded into the previous move
+	if (SavedDesiredGait != MyNewMove->SavedDesiredGait ||
+		SavedDesiredStance != MyNewMove->SavedDesiredStance ||
+		SavedDesiredRotationMode != MyNewMove->SavedDesiredRotationMode ||
+		SavedMaxWalkSpeed != MyNewMove->SavedMaxWalkSpeed)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void UALSCharacterMovementComponent::FSavedMove_My::PrepMoveFor(ACharacter* Character)
+{
+	Super::PrepMoveFor(Character);
+
+	UALSCharacterMovementComponent* CharacterMovement = Cast<UALSCharacterMovementComponent>(Character->GetCharacterMovement());
+	if (CharacterMovement)
+	{
+		CharacterMovement->ApplyMoveGravity(SavedGravityDirection, SavedGravityScale);
+		CharacterMovement->MyNewMaxWalkSpeed = SavedMaxWalkSpeed;
+		CharacterMovement->FixedStepTime = SavedFixedStepTime;
+		CharacterMovement->FixedStepForceTime = SavedFixedStepForceTime;
+		CharacterMovement->SmoothedWindForce = SavedSmoothedWindForce;
+	}
+}
+
+void UALSCharacterMovementComponent::FSavedMove_My::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	// The combined move is simulated again from the old move's start, fixed timestep remainder and wind included
+	SavedFixedStepTime = static_cast<const FSavedMove_My*>(OldMove)->SavedFixedStepTime;
+	SavedFixedStepForceTime = static_cast<const FSavedMove_My*>(OldMove)->SavedFixedStepForceTime;
+	SavedSmoothedWindForce = static_cast<const FSavedMove_My*>(OldMove)->SavedSmoothedWindForce;
+
+	UALSCharacterMovementComponent* CharacterMovement = Cast<UALSCharacterMovementComponent>(InCharacter->GetCharacterMovement());
+	if (CharacterMovement)
+	{
+		CharacterMovement->FixedStepTime = SavedFixedStepTime;
+		CharacterMovement->FixedStepForceTime = SavedFixedStepForceTime;
+		CharacterMovement->SmoothedWindForce = SavedSmoothedWindForce;
+	}
+}
+
+UALSCharacterMovementComponent::FALSCharacterNetworkMoveData::FALSCharacterNetworkMoveData()
+	: GravityDirection(FVector::DownVector)
+	, GravityScale(1.f)
+	, bHasAim(false)
+	, CameraRotation(FRotator::ZeroRotator)
+	, CameraPollRotation(FRotator::ZeroRotator)
+	, DesiredGait(0)
+	, DesiredStance(0)
+	, DesiredRotationMode(0)
+	, FixedStepTime(0.f)
+	, FixedStepForceTime(FVector::ZeroVector)
+{
+}
+
+void UALSCharacterMovementComponent::FALSCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_My& MyMove = static_cast<const FSavedMove_My&>(ClientMove);
+	GravityDirection = MyMove.SavedGravityDirection;
+	GravityScale = MyMove.SavedGravityScale;
+	DesiredGait = static_cast<uint8>(MyMove.SavedDesiredGait);
+	DesiredStance = static_cast<uint8>(MyMove.SavedDesiredStance);
+	DesiredRotationMode = static_cast<uint8>(MyMove.SavedDesiredRotationMode);
+	FixedStepTime = MyMove.SavedFixedStepTime;
+	FixedStepForceTime = MyMove.SavedFixedStepForceTime;
+
+	// Only the newest move carries aim, older moves in the same packet would just repeat stale values
+	bHasAim = false;
+	if (MoveType == ENetworkMoveType::NewMove && ClientMove.CharacterOwner.IsValid())
+	{
+		UALSCharacterMovementComponent* CharacterMovement = Cast<UALSCharacterMovementComponent>(ClientMove.CharacterOwner->GetCharacterMovement());
+		if (CharacterMovement && CharacterMovement->ShouldSendMoveAim(MyMove.SavedCameraRotation, MyMove.SavedCameraPollRotation))
+		{
+			bHasAim = true;
+			CameraRotation = MyMove.SavedCameraRotation;
+			CameraPollRotation = MyMove.SavedCameraPollRotation;
+		}
+	}
+}
+
+bool UALSCharacterMovementComponent::FALSCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Most moves run under default gravity, so only a deviation from it costs more than a bit
+	uint8 bHasCustomDirection = !GravityDirection.Equals(FVector::DownVector);
+	Ar.SerializeBits(&bHasCustomDirection, 1);
+	if (bHasCustomDirection)
+	{
+		bool bLocalSuccess = true;
+		GravityDirection.NetSerialize(Ar, PackageMap, bLocalSuccess);
+	}
+	else if (Ar.IsLoading())
+	{
+		GravityDirection = FVector::DownVector;
+	}
+
+	uint8 bHasCustomScale = GravityScale != 1.f;
+	Ar.SerializeBits(&bHasCustomScale, 1);
+	if (bHasCustomScale)
+	{
+		Ar << GravityScale;
+	}
+	else if (Ar.IsLoading())
+	{
+		GravityScale = 1.f;
+	}
+
+	// Gait and rotation mode fit in two bits each, stance in one
+	Ar.SerializeBits(&DesiredGait, 2);
+	Ar.SerializeBits(&DesiredStance, 1);
+	Ar.SerializeBits(&DesiredRotationMode, 2);
+
+	// Sent exactly, a rounded remainder would flip the substep count of moves ending near a substep boundary. The force
+	// carried over only exists alongside a remainder
+	uint8 bHasFixedStepTime = FixedStepTime != 0.f;
+	Ar.SerializeBits(&bHasFixedStepTime, 1);
+	if (bHasFixedStepTime)
+	{
+		Ar << FixedStepTime;
+		Ar << FixedStepForceTime;
+	}
+	else if (Ar.IsLoading())
+	{
+		FixedStepTime = 0.f;
+		FixedStepForceTime = FVector::ZeroVector;
+	}
+
+	Ar.SerializeBits(&bHasAim, 1);
+	if (bHasAim)
+	{
+		CameraRotation.SerializeCompressedShort(Ar);
+		CameraPollRotation.SerializeCompressedShort(Ar);
+	}
+
+	return !Ar.IsError();
+}
+
+UALSCharacterMovementComponent::FALSCharacterNetworkMoveDataContainer::FALSCharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
 UALSCharacterMovementComponent::FNetworkPredictionData_Client_My::FNetworkPredictionData_Client_My(
 	const UCharacterMovementComponent& ClientMovement)
 	: Super(ClientMovement)
@@ -338,18 +886,10 @@ FSavedMovePtr UALSCharacterMovementComponent::FNetworkPredictionData_Client_My::
 	return MakeShared<FSavedMove_My>();
 }
 
-void UALSCharacterMovementComponent::Server_SetMaxWalkingSpeed_Implementation(const float NewMaxWalkSpeed)
-{
-	MyNewMaxWalkSpeed = NewMaxWalkSpeed;
-}
-
 void UALSCharacterMovementComponent::SetMaxWalkingSpeed(float NewMaxWalkSpeed)
 {
-	if (PawnOwner->IsLocallyControlled())
-	{
-		MyNewMaxWalkSpeed = NewMaxWalkSpeed;
-		Server_SetMaxWalkingSpeed(NewMaxWalkSpeed);
-	}
+	// The server resolves the same speed from the desired states carried in each move
+	MyNewMaxWalkSpeed = NewMaxWalkSpeed;
 	bRequestMovementSettingsChange = true;
 }
 
@@ -424,7 +964,7 @@ void UALSCharacterMovementComponent::PhysFlying(float deltaTime, int32 Iteration
 		return;
 	}
 
-	if (!HasAnimRootMotion())
+	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
 	{
 		if (bCheatFlying && Acceleration.IsZero())
 		{
@@ -469,7 +1009,7 @@ void UALSCharacterMovementComponent::PhysFlying(float deltaTime, int32 Iteration
 		}
 	}
 
-	if (CharacterOwner && !bJustTeleported && !HasAnimRootMotion())
+	if (CharacterOwner && !bJustTeleported && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
 	{
 		Velocity = (CharacterOwner->GetActorLocation() - OldLocation) / deltaTime;
 	}
@@ -477,6 +1017,73 @@ void UALSCharacterMovementComponent::PhysFlying(float deltaTime, int32 Iteration
 	return;
 }
 
+void UALSCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == static_cast<uint8>(EALSCustomMovementMode::ZeroGravity))
+	{
+		PhysZeroGravity(deltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(deltaTime, Iterations);
+}
+
+void UALSCharacterMovementComponent::PhysZeroGravity(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{
+		// Nothing slows us down, input only adds thrust up to the fly speed and never brakes what external forces gave us
+		const float OldSpeedSq = Velocity.SizeSquared();
+		Velocity += Acceleration * deltaTime;
+		if (Velocity.SizeSquared() > FMath::Max(OldSpeedSq, FMath::Square(MaxFlySpeed)))
+		{
+			Velocity = Velocity.GetSafeNormal() * FMath::Max(FMath::Sqrt(OldSpeedSq), MaxFlySpeed);
+		}
+	}
+
+	ApplyRootMotionToVelocity(deltaTime);
+
+	// The control rotation travels with every move, so the server turns the capsule exactly like the owning client did
+	FQuat NewRotation = UpdatedComponent->GetComponentQuat();
+	const AController* Controller = CharacterOwner->Controller;
+	if (Controller && !HasAnimRootMotion())
+	{
+		NewRotation = FMath::QInterpConstantTo(NewRotation, Controller->GetControlRotation().Quaternion(), deltaTime,
+		                                       FMath::DegreesToRadians(ZeroGravityRotationRate));
+	}
+
+	Iterations++;
+	bJustTeleported = false;
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector Adjusted = Velocity * deltaTime;
+	FHitResult Hit(1.0f);
+	SafeMoveUpdatedComponent(Adjusted, NewRotation, true, Hit);
+
+	if (Hit.Time < 1.0f)
+	{
+		HandleImpact(Hit, deltaTime, Adjusted);
+		SlideAlongSurface(Adjusted, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+	}
+
+	// Whatever we bumped into took the velocity along its normal
+	if (!bJustTeleported && !HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
+	{
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+	}
+}
+
+bool UALSCharacterMovementComponent::IsInZeroGravity() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(EALSCustomMovementMode::ZeroGravity);
+}
+
 float UALSCharacterMovementComponent::BoostAirControl(float DeltaTime, float TickAirControl, const FVector& FallAcceleration)
 {
 	// Allow a burst of initial acceleration.
@@ -565,12 +1172,83 @@ void UALSCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previou
 
 void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 {
-	
+	if (!bUseFixedTimestep || FixedTimestep <= 0.0f || !HasValidData())
+	{
+		PerformMovementStep(DeltaTime);
+		return;
+	}
+
+	// Only whole substeps are simulated, the rest carries over. The server starts each client move from the
+	// remainder the client sent with it, so both run the same substeps for the same move delta.
+	const float AccumulatedTime = FixedStepTime + DeltaTime;
+	const int32 NumSteps = FMath::FloorToInt(AccumulatedTime / FixedTimestep);
+	FixedStepTime = FMath::Max(AccumulatedTime - NumSteps * FixedTimestep, 0.0f);
+
+	// Something other than movement put the capsule elsewhere, nothing to interpolate from
+	if (!UpdatedComponent->GetComponentTransform().Equals(FixedStepCurrTransform))
+	{
+		FixedStepPrevTransform = UpdatedComponent->GetComponentTransform();
+		FixedStepCurrTransform = FixedStepPrevTransform;
+	}
+
+	// Forces are integrated over time and spread evenly over the substeps, the part belonging to the remainder
+	// carries over so a frame without a substep doesn't lose its force. Impulses are used up by the first substep
+	FixedStepForceTime += PendingForceToApply * DeltaTime;
+	const FVector StepForce = AccumulatedTime > SMALL_NUMBER ? FixedStepForceTime / AccumulatedTime : FVector::ZeroVector;
+	for (int32 Step = 0; Step < FMath::Min(NumSteps, MaxFixedSubsteps) && HasValidData(); ++Step)
+	{
+		FixedStepPrevTransform = UpdatedComponent->GetComponentTransform();
+		PendingForceToApply = StepForce;
+		PerformMovementStep(FixedTimestep);
+	}
+
+	FixedStepForceTime = StepForce * FixedStepTime;
+	PendingForceToApply = FVector::ZeroVector;
+
+	if (HasValidData())
+	{
+		if (NumSteps > 0)
+		{
+			FixedStepCurrTransform = UpdatedComponent->GetComponentTransform();
+		}
+		UpdateFixedStepVisuals();
+	}
+}
+
+void UALSCharacterMovementComponent::UpdateFixedStepVisuals()
+{
+	// Dedicated servers draw nothing, remote players on a listen server are smoothed by the network code
+	USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+	if (!Mesh || Mesh->IsSimulatingPhysics() || IsNetMode(NM_DedicatedServer) ||
+		(!CharacterOwner->IsLocallyControlled() && CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy))
+	{
+		return;
+	}
+
+	// The mesh is drawn up to one substep behind the capsule
+	const float Alpha = FMath::Clamp(FixedStepTime / FixedTimestep, 0.0f, 1.0f);
+	const FVector VisualLocation = FMath::Lerp(FixedStepPrevTransform.GetLocation(), FixedStepCurrTransform.GetLocation(), Alpha);
+	const FQuat VisualRotation = FQuat::Slerp(FixedStepPrevTransform.GetRotation(), FixedStepCurrTransform.GetRotation(), Alpha);
+
+	const FTransform& CapsuleTransform = UpdatedComponent->GetComponentTransform();
+	const FVector MeshTranslationOffset = CapsuleTransform.InverseTransformVectorNoScale(VisualLocation - CapsuleTransform.GetLocation());
+	const FQuat MeshRotationOffset = CapsuleTransform.GetRotation().Inverse() * VisualRotation;
+	Mesh->SetRelativeLocationAndRotation(CharacterOwner->GetBaseTranslationOffset() + MeshTranslationOffset,
+	                                     MeshRotationOffset * CharacterOwner->GetBaseRotationOffset());
+}
+
+void UALSCharacterMovementComponent::PerformMovementStep(float DeltaTime)
+{
 	if (!HasValidData())
 	{
 		return;
 	}
 
+	// Split by gravity frame, compare both with p.ALSUseWorldGravityFrame and "stat ALSMovement"
+	FScopeCycleCounter PerformMovementCycleCounter(UsesWorldGravityFrame()
+		                                               ? GET_STATID(STAT_ALSPerformMovementWorldGravity)
+		                                               : GET_STATID(STAT_ALSPerformMovementCustomGravity));
+
 	// no movement if we can't move, or if currently doing physical simulation on UpdatedComponent
 	if (MovementMode == MOVE_None || UpdatedComponent->Mobility != EComponentMobility::Movable || UpdatedComponent->IsSimulatingPhysics())
 	{
@@ -596,6 +1274,9 @@ void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 		OldVelocity = Velocity;
 		OldLocation = CharacterOwner->GetActorLocation();
 
+		UpdateFieldGravity();
+		UpdateCentrifugalGravity();
+		ApplyForceChannels(DeltaTime);
 		ApplyAccumulatedForces(DeltaTime);
 
 		// Check for a change in crouch state. Players toggle crouch by changing bWantsToCrouch.
@@ -614,8 +1295,31 @@ void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 			TryToLeaveNavWalking();
 		}
 
-		// Character::LaunchCharacter() has been deferred until now.
-		HandlePendingLaunch();
+		// Character::LaunchCharacter() has been deferred until now.
+		HandlePendingLaunch();
+
+		// A client move flagged with a mantle start gets its ledge validated by the server here,
+		// so the mantle begins on the same move the client predicted it on.
+		if (bWantsToMantle && CharacterOwner->GetLocalRole() == ROLE_Authority)
+		{
+			AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(CharacterOwner);
+			if (Character)
+			{
+				Character->MantleCheckFromMove();
+			}
+		}
+
+		// Generate root motion to be used this frame from sources other than animation
+		if (HasRootMotionSources() && !CharacterOwner->bServerMoveIgnoreRootMotion)
+		{
+			CurrentRootMotion.PrepareRootMotion(DeltaTime, *CharacterOwner, *this, true);
+
+			// For local human clients, save off root motion data so it can be used by movement networking code.
+			if (CharacterOwner->IsLocallyControlled() && (CharacterOwner->GetRemoteRole() == ROLE_AutonomousProxy))
+			{
+				CharacterOwner->SavedRootMotion = CurrentRootMotion;
+			}
+		}
 
 		// If using RootMotion, tick animations before running physics.
 		if (!CharacterOwner->bClientUpdating && CharacterOwner->IsPlayingRootMotion() && CharacterOwner->GetMesh())
@@ -653,6 +1357,11 @@ void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 				CalcAnimRootMotionVelocity(RootMotionParams.GetRootMotionTransform().GetTranslation(), DeltaTime, Velocity);
 			}
 		}
+		else if (CurrentRootMotion.HasOverrideVelocity() && DeltaTime > 0.f)
+		{
+			// We don't have animation root motion so we apply other sources
+			CurrentRootMotion.AccumulateOverrideRootMotionVelocity(DeltaTime, *CharacterOwner, *this, Velocity);
+		}
 
 		// NaN tracking
 		checkf(!Velocity.ContainsNaN(), TEXT("UCharacterMovementComponentNew::PerformMovement: Velocity contains NaN (%s: %s)\n%s"), *GetPathNameSafe(this), *GetPathNameSafe(GetOuter()), *Velocity.ToString());
@@ -693,6 +1402,19 @@ void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 			// Root Motion has been used, clear
 			RootMotionParams.Clear();
 		}
+		else if (MantleRootMotionSourceID != (uint16)ERootMotionSourceID::Invalid)
+		{
+			// The mantle source carries its rotation as a delta to the actor rotation it was prepared against
+			const TSharedPtr<FRootMotionSource> MantleSource = GetRootMotionSourceByID(MantleRootMotionSourceID);
+			if (MantleSource.IsValid() && MantleSource->RootMotionParams.bHasRootMotion)
+			{
+				const FQuat DeltaRotation = MantleSource->RootMotionParams.GetRootMotionTransform().GetRotation();
+				if (!DeltaRotation.IsIdentity())
+				{
+					MoveUpdatedComponent(FVector::ZeroVector, DeltaRotation * UpdatedComponent->GetComponentQuat(), true);
+				}
+			}
+		}
 
 		// consume path following requested velocity
 		bHasRequestedVelocity = false;
@@ -706,7 +1428,15 @@ void UALSCharacterMovementComponent::PerformMovement(float DeltaTime)
 	SaveBaseLocation();
 	UpdateComponentVelocity();
 
-	
+	// AI sweep for the next frame once every actor has moved
+	if (UsesAsyncMovementQueries())
+	{
+		if (UALSMovementQuerySubsystem* QuerySubsystem = UALSMovementQuerySubsystem::Get(this))
+		{
+			QuerySubsystem->QueueQueries(this);
+		}
+	}
+
 	const bool bHasAuthority = CharacterOwner && CharacterOwner->HasAuthority();
 	const UWorld* MyWorld = GetWorld();
 	// If we move we want to avoid a long delay before replication catches up to notice this change, especially if it's throttling our rate.
@@ -808,16 +1538,29 @@ void UALSCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float
 
 void UALSCharacterMovementComponent::MaintainHorizontalGroundVelocity()
 {
-	//return;
+	if (UsesWorldGravityFrame())
+	{
+		MaintainHorizontalGroundVelocityImpl<FALSWorldGravityFrame>();
+	}
+	else
+	{
+		MaintainHorizontalGroundVelocityImpl<FALSCustomGravityFrame>();
+	}
+}
+
+template <typename GravityFrame>
+void UALSCharacterMovementComponent::MaintainHorizontalGroundVelocityImpl()
+{
+	const FVector CapsuleUp = GravityFrame::GetCapsuleUp(GetCapsuleRotation());
 	if (bMaintainHorizontalGroundVelocity)
 	{
 		// Just remove the vertical component.
-		Velocity = FVector::VectorPlaneProject(Velocity, GetCapsuleAxisZ());
+		Velocity = GravityFrame::ProjectOntoPlane(Velocity, CapsuleUp);
 	}
 	else
 	{
 		// Project the vector and maintain its original magnitude.
-		Velocity = FVector::VectorPlaneProject(Velocity, GetCapsuleAxisZ()).GetSafeNormal() * Velocity.Size();
+		Velocity = GravityFrame::ProjectOntoPlane(Velocity, CapsuleUp).GetSafeNormal() * Velocity.Size();
 	}
 }
 
@@ -882,6 +1625,19 @@ void UALSCharacterMovementComponent::SetPostLandedPhysics(const FHitResult& Hit)
 
 
 void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
+{
+	if (UsesWorldGravityFrame())
+	{
+		PhysWalkingImpl<FALSWorldGravityFrame>(deltaTime, Iterations);
+	}
+	else
+	{
+		PhysWalkingImpl<FALSCustomGravityFrame>(deltaTime, Iterations);
+	}
+}
+
+template <typename GravityFrame>
+void UALSCharacterMovementComponent::PhysWalkingImpl(float deltaTime, int32 Iterations)
 {
 	//SCOPE_CYCLE_COUNTER(STAT_CharPhysWalking);
 	
@@ -929,7 +1685,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 		const FFindFloorResult OldFloor = CurrentFloor;
 
 		// Acceleration is already horizontal; ensure velocity is also horizontal.
-		MaintainHorizontalGroundVelocity();
+		MaintainHorizontalGroundVelocityImpl<GravityFrame>();
 
 		const FVector OldVelocity = Velocity;
 
@@ -963,7 +1719,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 				const float DesiredDist = Delta.Size();
 				if (DesiredDist > KINDA_SMALL_NUMBER)
 				{
-					const float ActualDist = FVector::VectorPlaneProject(CharacterOwner->GetActorLocation() - OldLocation, GetCapsuleAxisZ()).Size();
+					const float ActualDist = GravityFrame::ProjectOntoPlane(CharacterOwner->GetActorLocation() - OldLocation, GravityFrame::GetCapsuleUp(GetCapsuleRotation())).Size();
 					RemainingTime += TimeTick * (1.0f - FMath::Min(1.0f, ActualDist / DesiredDist));
 				}
 
@@ -993,7 +1749,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 		if (bCheckLedges && !CurrentFloor.IsWalkableFloor())
 		{
 			// Calculate possible alternate movement.
-			const FVector NewDelta = bTriedLedgeMove ? FVector::ZeroVector : GetLedgeMove(OldLocation, Delta, GetCapsuleAxisZ() * -1.0f);
+			const FVector NewDelta = bTriedLedgeMove ? FVector::ZeroVector : GetLedgeMove(OldLocation, Delta, GravityFrame::GetCapsuleUp(GetCapsuleRotation()) * -1.0f);
 			if (!NewDelta.IsZero())
 			{
 				// First revert this move.
@@ -1050,7 +1806,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 				// The floor check failed because it started in penetration.
 				// We do not want to try to move downward because the downward sweep failed, rather we'd like to try to pop out of the floor.
 				FHitResult Hit(CurrentFloor.HitResult);
-				Hit.TraceEnd = Hit.TraceStart + GetCapsuleAxisZ() * MAX_FLOOR_DIST;
+				Hit.TraceEnd = Hit.TraceStart + GravityFrame::GetCapsuleUp(GetCapsuleRotation()) * MAX_FLOOR_DIST;
 				const FVector RequestedAdjustment = GetPenetrationAdjustment(Hit);
 				ResolvePenetration(RequestedAdjustment, Hit, CharacterOwner->GetActorRotation());
 			}
@@ -1082,7 +1838,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 			if (!bJustTeleported && !HasAnimRootMotion() && TimeTick >= MIN_TICK_TIME)
 			{
 				Velocity = (CharacterOwner->GetActorLocation() - OldLocation) / TimeTick;
-				MaintainHorizontalGroundVelocity();
+				MaintainHorizontalGroundVelocityImpl<GravityFrame>();
 			}
 		}
 
@@ -1096,7 +1852,7 @@ void UALSCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iteratio
 
 	if (IsMovingOnGround())
 	{
-		MaintainHorizontalGroundVelocity();
+		MaintainHorizontalGroundVelocityImpl<GravityFrame>();
 	}
 }
 
@@ -1315,74 +2071,95 @@ void UALSCharacterMovementComponent::SimulateMovement(float DeltaTime)
 		// Simulated pawns predict location.
 		OldVelocity = Velocity;
 		OldLocation = UpdatedComponent->GetComponentLocation();
-		FStepDownResult StepDownResult;
-		MoveSmooth(Velocity, DeltaTime, &StepDownResult);
-
-		// Consume path following requested velocity.
-		bHasRequestedVelocity = false;
-
-		// If simulated gravity, find floor and check if falling.
-		const bool bEnableFloorCheck = (!CharacterOwner->bSimGravityDisabled || !bIsSimulatedProxy);
-		if (bEnableFloorCheck && (IsMovingOnGround() || MovementMode == MOVE_Falling))
+		// Far and unseen proxies simulate less, see p.ALSMovementLOD
+		if (!bIsSimulatedProxy || UpdateSimulatedMovementLOD(DeltaTime))
 		{
-			const FVector Gravity = GetGravity();
+			FStepDownResult StepDownResult;
+			MoveSmooth(Velocity, DeltaTime, &StepDownResult);
 
-			if (StepDownResult.bComputedFloor)
-			{
-				CurrentFloor = StepDownResult.FloorResult;
-			}
-			else
+			// Consume path following requested velocity.
+			bHasRequestedVelocity = false;
+
+			// If simulated gravity, find floor and check if falling.
+			const bool bEnableFloorCheck = (!CharacterOwner->bSimGravityDisabled || !bIsSimulatedProxy);
+			if (bEnableFloorCheck && (IsMovingOnGround() || MovementMode == MOVE_Falling))
 			{
-				
+				const FVector Gravity = GetGravity();
 
-				// Given the lenght of the velocity vector and the gravity vector being unpredictable, we cannot get consistent dot products between them. 
-				// To compensate we will normalize both vectors using unit vector, get the dot product, and check if the dot product is below a certain threshold. 
-				// this threshold is not simply >= 0 because of the delay between the velocity being updated through replication and the rotation being updated. 
-				FVector VelocityDirection = UKismetMathLibrary::GetDirectionUnitVector(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + Velocity);
-				FVector GravUnit = UKismetMathLibrary::GetDirectionUnitVector(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + Gravity);
-				float DeltaQuatDot = FVector::DotProduct(VelocityDirection, GravUnit);
-				//UE_LOG(LogClass, Warning, TEXT(" Velocity Gravity Dot : %f"), DeltaQuatDot);
-				//if (!Gravity.IsZero() && (VelocityDirection | Gravity) >= 0.0f)
-				if (!Gravity.IsZero() && DeltaQuatDot >= -0.2f)
-				{ 
-					FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, Velocity.IsZero(), NULL);
+				if (StepDownResult.bComputedFloor)
+				{
+					CurrentFloor = StepDownResult.FloorResult;
 				}
 				else
 				{
-					CurrentFloor.Clear();
+				
+
+					// Given the lenght of the velocity vector and the gravity vector being unpredictable, we cannot get consistent dot products between them. 
+					// To compensate we will normalize both vectors using unit vector, get the dot product, and check if the dot product is below a certain threshold. 
+					// this threshold is not simply >= 0 because of the delay between the velocity being updated through replication and the rotation being updated. 
+					FVector VelocityDirection = UKismetMathLibrary::GetDirectionUnitVector(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + Velocity);
+					FVector GravUnit = UKismetMathLibrary::GetDirectionUnitVector(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + Gravity);
+					float DeltaQuatDot = FVector::DotProduct(VelocityDirection, GravUnit);
+					//UE_LOG(LogClass, Warning, TEXT(" Velocity Gravity Dot : %f"), DeltaQuatDot);
+					//if (!Gravity.IsZero() && (VelocityDirection | Gravity) >= 0.0f)
+					if (!Gravity.IsZero() && DeltaQuatDot >= -0.2f)
+					{ 
+						FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, Velocity.IsZero(), NULL);
+					}
+					else
+					{
+						CurrentFloor.Clear();
+					}
 				}
-			}
 
-			if (!CurrentFloor.IsWalkableFloor())
-			{
-				// No floor, must fall.
-				Velocity = NewFallVelocity(Velocity, Gravity, DeltaTime);
-				SetMovementMode(MOVE_Falling);
-			}
-			else
-			{
-				// Walkable floor.
-				if (IsMovingOnGround())
+				if (!CurrentFloor.IsWalkableFloor())
 				{
-					AdjustFloorHeight();
-					SetBase(CurrentFloor.HitResult.Component.Get(), CurrentFloor.HitResult.BoneName);
+					// No floor, must fall.
+					Velocity = NewFallVelocity(Velocity, Gravity, DeltaTime);
+					SetMovementMode(MOVE_Falling);
 				}
-				else if (MovementMode == MOVE_Falling)
+				else
 				{
-					if (CurrentFloor.FloorDist <= MIN_FLOOR_DIST)
+					// Walkable floor.
+					if (IsMovingOnGround())
 					{
-						// Landed.
-						SetMovementMode(MOVE_Walking);
+						AdjustFloorHeight();
+						SetBase(CurrentFloor.HitResult.Component.Get(), CurrentFloor.HitResult.BoneName);
 					}
-					else
+					else if (MovementMode == MOVE_Falling)
 					{
-						// Continue falling.
-						Velocity = NewFallVelocity(Velocity, Gravity, DeltaTime);
-						CurrentFloor.Clear();
+						if (CurrentFloor.FloorDist <= MIN_FLOOR_DIST)
+						{
+							// Landed.
+							SetMovementMode(MOVE_Walking);
+						}
+						else
+						{
+							// Continue falling.
+							Velocity = NewFallVelocity(Velocity, Gravity, DeltaTime);
+							CurrentFloor.Clear();
+						}
 					}
 				}
 			}
 		}
+		else if (MovementLOD == EALSMovementLOD::Reduced)
+		{
+			// Carry on along the last simulated velocity with a single sweep, so proxies can't tunnel through floors
+			// and walls. Stepping and floor are resolved by the next full step
+			if (MovementMode == MOVE_Falling)
+			{
+				Velocity = NewFallVelocity(Velocity, GetGravity(), DeltaTime);
+			}
+
+			FHitResult Hit(1.f);
+			SafeMoveUpdatedComponent(Velocity * DeltaTime, UpdatedComponent->GetComponentQuat(), true, Hit);
+			if (Hit.IsValidBlockingHit())
+			{
+				// Stop pushing into what we hit until the next full step slides along it
+				Velocity = FVector::VectorPlaneProject(Velocity, Hit.Normal);
+			}
+		}
 
 		OnMovementUpdated(DeltaTime, OldLocation, OldVelocity);
 	} // End scoped movement update.
@@ -1401,6 +2178,84 @@ void UALSCharacterMovementComponent::SimulateMovement(float DeltaTime)
 	//UpdateComponentRotation();
 }
 
+bool UALSCharacterMovementComponent::UpdateSimulatedMovementLOD(float DeltaTime)
+{
+	if (!CharacterMovementCVars::EnableMovementLOD)
+	{
+		MovementLOD = EALSMovementLOD::Full;
+		return true;
+	}
+
+	const float WorldTime = GetWorld()->GetTimeSeconds();
+	if (WorldTime >= NextMovementLODTime)
+	{
+		NextMovementLODTime = WorldTime + MOVEMENT_LOD_EVALUATE_INTERVAL;
+		MovementLOD = ComputeMovementLOD();
+	}
+
+#if ENABLE_DRAW_DEBUG
+	if (CharacterMovementCVars::MovementLODDebug)
+	{
+		static const FColor LODColors[] = {FColor::Green, FColor::Yellow, FColor::Red};
+		const float HalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		DrawDebugString(GetWorld(), UpdatedComponent->GetComponentLocation() + GetCapsuleAxisZ() * HalfHeight * 1.2f,
+		                GetEnumerationToString(MovementLOD), nullptr, LODColors[static_cast<uint8>(MovementLOD)], 0.0f);
+	}
+#endif
+
+	MovementLODAccumulatedTime += DeltaTime;
+	switch (MovementLOD)
+	{
+	case EALSMovementLOD::Reduced:
+		if (MovementLODAccumulatedTime < CharacterMovementCVars::MovementLODReducedInterval)
+		{
+			return false;
+		}
+		break;
+	case EALSMovementLOD::Minimal:
+		// Nothing predicted, the capsule stays where the last replicated movement put it
+		MovementLODAccumulatedTime = 0.0f;
+		return false;
+	default:
+		break;
+	}
+
+	MovementLODAccumulatedTime = 0.0f;
+	return true;
+}
+
+EALSMovementLOD UALSCharacterMovementComponent::ComputeMovementLOD() const
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	float BestDistSquared = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			BestDistSquared = FMath::Min(BestDistSquared, FVector::DistSquared(PC->PlayerCameraManager->GetCameraLocation(), Location));
+		}
+	}
+
+	// Nobody looking, e.g. while the local player is still being set up
+	if (BestDistSquared == MAX_flt)
+	{
+		return EALSMovementLOD::Full;
+	}
+
+	int32 LOD = BestDistSquared >= FMath::Square(CharacterMovementCVars::MovementLODMinimalDistance) ? 2
+		: BestDistSquared >= FMath::Square(CharacterMovementCVars::MovementLODReducedDistance) ? 1 : 0;
+
+	const USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+	const float NotRenderedTime = CharacterMovementCVars::MovementLODNotRenderedTime;
+	if (NotRenderedTime > 0.0f && Mesh && !Mesh->WasRecentlyRendered(NotRenderedTime))
+	{
+		LOD = FMath::Min(LOD + 1, 2);
+	}
+
+	return static_cast<EALSMovementLOD>(LOD);
+}
+
 FVector UALSCharacterMovementComponent::ConstrainInputAcceleration(const FVector& InputAcceleration) const
 {
 	FVector NewAccel = InputAcceleration;
@@ -1474,6 +2329,19 @@ void UALSCharacterMovementComponent::StartFalling(int32 Iterations, float remain
 }
 
 void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterations)
+{
+	if (UsesWorldGravityFrame())
+	{
+		PhysFallingImpl<FALSWorldGravityFrame>(deltaTime, Iterations);
+	}
+	else
+	{
+		PhysFallingImpl<FALSCustomGravityFrame>(deltaTime, Iterations);
+	}
+}
+
+template <typename GravityFrame>
+void UALSCharacterMovementComponent::PhysFallingImpl(float deltaTime, int32 Iterations)
 {
 	if (deltaTime < MIN_TICK_TIME)
 	{
@@ -1481,8 +2349,7 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 	}
 
 	// Abort if no valid gravity can be obtained.
-	const FVector GravityDirection = GetGravityDirection();
-	const FVector GravityDir = GetGravityDirection();
+	const FVector GravityDir = GravityFrame::bWorldAligned ? FVector::DownVector : GetGravityDirection();
 	if (GravityDir.IsZero())
 	{
 		Acceleration = FVector::ZeroVector;
@@ -1493,11 +2360,15 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 	FVector FallAcceleration = GetFallingLateralAcceleration(deltaTime);
 	const bool bHasAirControl = FallAcceleration.SizeSquared() > 0.0f;
 
+	// Nothing but gravity and external forces acting, the arc is known exactly and needs no time steps
+	const bool bBallistic = CharacterMovementCVars::AnalyticFalling && !bHasAirControl && !HasAnimRootMotion() &&
+		!CurrentRootMotion.HasOverrideVelocity() && !bHasRequestedVelocity && FallingLateralFriction <= 0.0f && BrakingDecelerationFalling <= 0.0f;
+
 	float RemainingTime = deltaTime;
 	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations)
 	{
 		Iterations++;
-		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		const float TimeTick = bBallistic ? RemainingTime : GetSimulationTimeStep(RemainingTime, Iterations);
 		RemainingTime -= TimeTick;
 
 		const FVector OldLocation = CharacterOwner->GetActorLocation();
@@ -1515,7 +2386,7 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 		// Apply input.
 		if (!HasAnimRootMotion())
 		{
-			const FVector OldVelocityZ = GravityDir * (Velocity | GravityDir);
+			const FVector OldVelocityZ = GravityFrame::ProjectOntoAxis(Velocity, GravityDir);
 
 			// Compute VelocityNoAirControl.
 			if (bHasAirControl)
@@ -1524,9 +2395,9 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 				TGuardValue<FVector> RestoreAcceleration(Acceleration, FVector::ZeroVector);
 				TGuardValue<FVector> RestoreVelocity(Velocity, Velocity);
 
-				Velocity = FVector::VectorPlaneProject(Velocity, GravityDir);
+				Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir);
 				CalcVelocity(TimeTick, FallingLateralFriction, false, BrakingDecelerationFalling);
-				VelocityNoAirControl = FVector::VectorPlaneProject(Velocity, GravityDir) + OldVelocityZ;
+				VelocityNoAirControl = GravityFrame::ProjectOntoPlane(Velocity, GravityDir) + OldVelocityZ;
 			}
 
 			// Compute Velocity.
@@ -1534,9 +2405,9 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 				// Acceleration = FallAcceleration for CalcVelocity(), but we restore it after using it.
 				TGuardValue<FVector> RestoreAcceleration(Acceleration, FallAcceleration);
 
-				Velocity = FVector::VectorPlaneProject(Velocity, GravityDir);
+				Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir);
 				CalcVelocity(TimeTick, FallingLateralFriction, false, BrakingDecelerationFalling);
-				Velocity = FVector::VectorPlaneProject(Velocity, GravityDir) + OldVelocityZ;
+				Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir) + OldVelocityZ;
 
 
 			}
@@ -1550,11 +2421,20 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 
 		// Apply gravity.
 		const FVector Gravity = GetGravity();
-		Velocity = NewFallVelocity(Velocity, Gravity, TimeTick);
-		VelocityNoAirControl = NewFallVelocity(VelocityNoAirControl, Gravity, TimeTick);
+		FVector BallisticDelta = FVector::ZeroVector;
+		if (bBallistic)
+		{
+			BallisticDelta = ComputeFallingMove(Velocity, Gravity + FallingExternalAcceleration, GravityDir, TimeTick, Velocity);
+			VelocityNoAirControl = Velocity;
+		}
+		else
+		{
+			Velocity = NewFallVelocity(Velocity + FallingExternalAcceleration * TimeTick, Gravity, TimeTick);
+			VelocityNoAirControl = NewFallVelocity(VelocityNoAirControl + FallingExternalAcceleration * TimeTick, Gravity, TimeTick);
+		}
 		const FVector AirControlAccel = (Velocity - VelocityNoAirControl) / TimeTick;
 
-		if (bNotifyApex && CharacterOwner->Controller && ((Velocity | GravityDir) * -1.0f) <= 0.0f)
+		if (bNotifyApex && CharacterOwner->Controller && (GravityFrame::DotAxis(Velocity, GravityDir) * -1.0f) <= 0.0f)
 		{
 			// Just passed jump apex since now going down.
 			bNotifyApex = false;
@@ -1565,7 +2445,45 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 		FHitResult Hit(1.0f);
 		FVector Adjusted = 0.5f * (OldVelocity + Velocity) * TimeTick;
 
-		SafeMoveUpdatedComponent(Adjusted, PawnRotation, true, Hit);
+		if (bBallistic)
+		{
+			// Follow the arc with as few straight sweeps as keep within p.ALSFallingArcTolerance of it, a parabola bulges at most A*T^2/8 from its chord
+			const FVector ArcAcceleration = Gravity + FallingExternalAcceleration;
+			const int32 NumSegments = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt(ArcAcceleration.Size() * FMath::Square(TimeTick) /
+				(8.0f * FMath::Max(CharacterMovementCVars::FallingArcTolerance, KINDA_SMALL_NUMBER)))), 1, 8);
+
+			FVector SegmentStartDelta = FVector::ZeroVector;
+			for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+			{
+				const float SegmentStartTime = TimeTick * (Segment - 1) / NumSegments;
+				const float SegmentTime = TimeTick / NumSegments;
+				FVector SegmentEndVelocity;
+				const FVector SegmentEndDelta = Segment == NumSegments ? BallisticDelta
+					: ComputeFallingMove(OldVelocity, ArcAcceleration, GravityDir, SegmentStartTime + SegmentTime, SegmentEndVelocity);
+
+				SafeMoveUpdatedComponent(SegmentEndDelta - SegmentStartDelta, PawnRotation, true, Hit);
+				if (!HasValidData())
+				{
+					break;
+				}
+
+				if (Hit.bBlockingHit)
+				{
+					// Hand the impact to the iterative handling below as a hit at that time of the whole tick, with the velocity there
+					const float HitTime = SegmentStartTime + Hit.Time * SegmentTime;
+					Hit.Time = HitTime / TimeTick;
+					ComputeFallingMove(OldVelocity, ArcAcceleration, GravityDir, HitTime, Velocity);
+					VelocityNoAirControl = Velocity;
+					break;
+				}
+
+				SegmentStartDelta = SegmentEndDelta;
+			}
+		}
+		else
+		{
+			SafeMoveUpdatedComponent(Adjusted, PawnRotation, true, Hit);
+		}
 
 		if (!HasValidData())
 		{
@@ -1641,7 +2559,7 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 					}
 					else
 					{
-						Velocity = FVector::VectorPlaneProject(Velocity, GravityDir) + GravityDir * (NewVelocity | GravityDir);
+						Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir) + GravityFrame::ProjectOntoAxis(NewVelocity, GravityDir);
 					}
 				}
 
@@ -1672,7 +2590,7 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 						}
 
 						// Act as if there was no air control on the last move when computing new deflection.
-						if (bHasAirControl && (Hit.Normal | GravityDir) < -VERTICAL_SLOPE_NORMAL_Z)
+						if (bHasAirControl && GravityFrame::DotAxis(Hit.Normal, GravityDir) < -VERTICAL_SLOPE_NORMAL_Z)
 						{
 							Delta = ComputeSlideVector(VelocityNoAirControl * LastMoveTimeSlice, 1.0f, OldHitNormal, Hit);
 						}
@@ -1703,23 +2621,23 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 							}
 							else
 							{
-								Velocity = FVector::VectorPlaneProject(Velocity, GravityDir) + GravityDir * (NewVelocity | GravityDir);
+								Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir) + GravityFrame::ProjectOntoAxis(NewVelocity, GravityDir);
 							}
 						}
 
 						// bDitch=true means that pawn is straddling two slopes, neither of which he can stand on.
-						bool bDitch = ((OldHitImpactNormal | GravityDir) < 0.0f && (Hit.ImpactNormal | GravityDir) < 0.0f &&
-							FMath::Abs(Delta | GravityDir) <= KINDA_SMALL_NUMBER && (Hit.ImpactNormal | OldHitImpactNormal) < 0.0f);
+						bool bDitch = (GravityFrame::DotAxis(OldHitImpactNormal, GravityDir) < 0.0f && GravityFrame::DotAxis(Hit.ImpactNormal, GravityDir) < 0.0f &&
+							FMath::Abs(GravityFrame::DotAxis(Delta, GravityDir)) <= KINDA_SMALL_NUMBER && (Hit.ImpactNormal | OldHitImpactNormal) < 0.0f);
 
 						SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
 
 						if (Hit.Time == 0.0f)
 						{
 							// If we are stuck then try to side step.
-							FVector SideDelta = FVector::VectorPlaneProject(OldHitNormal + Hit.ImpactNormal, GravityDir).GetSafeNormal();
+							FVector SideDelta = GravityFrame::ProjectOntoPlane(OldHitNormal + Hit.ImpactNormal, GravityDir).GetSafeNormal();
 							if (SideDelta.IsNearlyZero())
 							{
-								SideDelta = GravityDir ^ (FVector::VectorPlaneProject(OldHitNormal, GravityDir).GetSafeNormal());
+								SideDelta = GravityDir ^ (GravityFrame::ProjectOntoPlane(OldHitNormal, GravityDir).GetSafeNormal());
 							}
 
 							SafeMoveUpdatedComponent(SideDelta, PawnRotation, true, Hit);
@@ -1732,19 +2650,19 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 
 							return;
 						}
-						else if (GetPerchRadiusThreshold() > 0.0f && Hit.Time == 1.0f && (OldHitImpactNormal | GravityDir) <= -GetWalkableFloorZ())
+						else if (GetPerchRadiusThreshold() > 0.0f && Hit.Time == 1.0f && GravityFrame::DotAxis(OldHitImpactNormal, GravityDir) <= -GetWalkableFloorZ())
 						{
 							// We might be in a virtual 'ditch' within our perch radius. This is rare.
 							const FVector PawnLocation = CharacterOwner->GetActorLocation();
-							const float ZMovedDist = FMath::Abs((PawnLocation - OldLocation) | GravityDir);
-							const float MovedDist2DSq = (FVector::VectorPlaneProject(PawnLocation - OldLocation, GravityDir)).SizeSquared();
+							const float ZMovedDist = FMath::Abs(GravityFrame::DotAxis(PawnLocation - OldLocation, GravityDir));
+							const float MovedDist2DSq = (GravityFrame::ProjectOntoPlane(PawnLocation - OldLocation, GravityDir)).SizeSquared();
 
 							if (ZMovedDist <= 0.2f * TimeTick && MovedDist2DSq <= 4.0f * TimeTick)
 							{
 								Velocity.X += 0.25f * GetMaxSpeed() * (FMath::FRand() - 0.5f);
 								Velocity.Y += 0.25f * GetMaxSpeed() * (FMath::FRand() - 0.5f);
 								Velocity.Z += 0.25f * GetMaxSpeed() * (FMath::FRand() - 0.5f);
-								Velocity = FVector::VectorPlaneProject(Velocity, GravityDir) + GravityDir * (FMath::Max<float>(JumpZVelocity * 0.25f, 1.0f) * -1.0f);
+								Velocity = GravityFrame::ProjectOntoPlane(Velocity, GravityDir) + GravityDir * (FMath::Max<float>(JumpZVelocity * 0.25f, 1.0f) * -1.0f);
 								Delta = Velocity * TimeTick;
 
 								SafeMoveUpdatedComponent(Delta, PawnRotation, true, Hit);
@@ -1755,9 +2673,9 @@ void UALSCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iteratio
 			}
 		}
 
-		if ((FVector::VectorPlaneProject(Velocity, GravityDir)).SizeSquared() <= KINDA_SMALL_NUMBER * 10.0f)
+		if ((GravityFrame::ProjectOntoPlane(Velocity, GravityDir)).SizeSquared() <= KINDA_SMALL_NUMBER * 10.0f)
 		{
-			Velocity = GravityDir * (Velocity | GravityDir);
+			Velocity = GravityFrame::ProjectOntoAxis(Velocity, GravityDir);
 		}
 	}
 
@@ -1810,6 +2728,34 @@ FVector UALSCharacterMovementComponent::NewFallVelocity(const FVector& InitialVe
 	return Result;
 }
 
+FVector UALSCharacterMovementComponent::ComputeFallingMove(const FVector& InitialVelocity, const FVector& FallAcceleration, const FVector& GravityDir, float Time, FVector& OutVelocity) const
+{
+	// Across gravity the acceleration is constant
+	const FVector AccelerationPlanar = FVector::VectorPlaneProject(FallAcceleration, GravityDir);
+	const FVector VelocityPlanar = FVector::VectorPlaneProject(InitialVelocity, GravityDir);
+	const FVector DeltaPlanar = VelocityPlanar * Time + AccelerationPlanar * (0.5f * FMath::Square(Time));
+
+	// Along gravity it is constant until terminal velocity is reached, as in NewFallVelocity
+	const float TerminalLimit = FMath::Abs(GetPhysicsVolume()->TerminalVelocity);
+	const float AccelerationZ = FallAcceleration | GravityDir;
+	const float VelocityZ = InitialVelocity | GravityDir;
+	float DeltaZ;
+	float EndVelocityZ = VelocityZ + AccelerationZ * Time;
+	if (AccelerationZ <= 0.0f || EndVelocityZ <= TerminalLimit)
+	{
+		DeltaZ = VelocityZ * Time + AccelerationZ * (0.5f * FMath::Square(Time));
+	}
+	else
+	{
+		const float TerminalTime = FMath::Clamp((TerminalLimit - VelocityZ) / AccelerationZ, 0.0f, Time);
+		DeltaZ = VelocityZ * TerminalTime + AccelerationZ * (0.5f * FMath::Square(TerminalTime)) + TerminalLimit * (Time - TerminalTime);
+		EndVelocityZ = TerminalLimit;
+	}
+
+	OutVelocity = VelocityPlanar + AccelerationPlanar * Time + GravityDir * EndVelocityZ;
+	return DeltaPlanar + GravityDir * DeltaZ;
+}
+
 void UALSCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 {
 	if (!HasValidData())
@@ -1829,6 +2775,13 @@ void UALSCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 		return;
 	}
 
+	UALSRotatingBaseComponent* RotatingBase = CharacterMovementCVars::RotatingBaseFastPath ? GetRotatingBase(MovementBase) : nullptr;
+	if (RotatingBase && RotatingBase == OldRotatingBase.Get() && !MovementBase->IsSimulatingPhysics() && !CharacterOwner->IsMatineeControlled())
+	{
+		UpdateRotatingBasedMovement(RotatingBase);
+		return;
+	}
+
 	// Ignore collision with bases during these movements.
 	TGuardValue<EMoveComponentFlags> ScopedFlagRestore(MoveComponentFlags, MoveComponentFlags | MOVECOMP_IgnoreBases);
 
@@ -1912,11 +2865,199 @@ void UALSCharacterMovementComponent::UpdateBasedMovement(float DeltaSeconds)
 			}
 		}
 
-		if (MovementBase->IsSimulatingPhysics() && CharacterOwner->GetMesh())
-		{
-			CharacterOwner->GetMesh()->ApplyDeltaToAllPhysicsTransforms(DeltaPosition, DeltaQuat);
-		}
+		if (MovementBase->IsSimulatingPhysics() && CharacterOwner->GetMesh())
+		{
+			CharacterOwner->GetMesh()->ApplyDeltaToAllPhysicsTransforms(DeltaPosition, DeltaQuat);
+		}
+	}
+}
+
+void UALSCharacterMovementComponent::SaveBaseLocation()
+{
+	Super::SaveBaseLocation();
+
+	OldRotatingBase = nullptr;
+	if (HasValidData() && CharacterMovementCVars::RotatingBaseFastPath)
+	{
+		UALSRotatingBaseComponent* RotatingBase = GetRotatingBase(CharacterOwner->GetMovementBase());
+		if (RotatingBase)
+		{
+			OldRotatingBase = RotatingBase;
+			OldRotatingBaseAngle = RotatingBase->GetSpinAngle();
+		}
+	}
+}
+
+UALSRotatingBaseComponent* UALSCharacterMovementComponent::GetRotatingBase(const UPrimitiveComponent* MovementBase) const
+{
+	const AActor* BaseOwner = MovementBase ? MovementBase->GetOwner() : nullptr;
+	if (!BaseOwner)
+	{
+		return nullptr;
+	}
+
+	// Characters stay on the same base for long stretches, only look the component up when it changes
+	if (CachedRotatingBaseOwner.Get() != BaseOwner)
+	{
+		CachedRotatingBaseOwner = BaseOwner;
+		CachedRotatingBase = BaseOwner->FindComponentByClass<UALSRotatingBaseComponent>();
+	}
+
+	return CachedRotatingBase.Get();
+}
+
+void UALSCharacterMovementComponent::UpdateRotatingBasedMovement(UALSRotatingBaseComponent* RotatingBase)
+{
+	// Make sure the base sits at the angle we follow, whichever of us ticked first
+	RotatingBase->UpdateBasePose();
+
+	const float SpinAngle = RotatingBase->GetSpinAngle();
+	const float DeltaAngle = FMath::FindDeltaAngleDegrees(OldRotatingBaseAngle, SpinAngle);
+	if (FMath::IsNearlyZero(DeltaAngle))
+	{
+		return;
+	}
+
+	// Ignore collision with bases during these movements.
+	TGuardValue<EMoveComponentFlags> ScopedFlagRestore(MoveComponentFlags, MoveComponentFlags | MOVECOMP_IgnoreBases);
+
+	// Rigid rotation about the spin axis carries the capsule, its orientation and its base relative velocity along
+	const FVector Pivot = RotatingBase->GetWorldPivot();
+	const FQuat DeltaQuat(RotatingBase->GetWorldSpinAxis(), FMath::DegreesToRadians(DeltaAngle));
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector DeltaPosition = ConstrainDirectionToPlane(Pivot + DeltaQuat.RotateVector(OldLocation - Pivot) - OldLocation);
+
+	FQuat FinalQuat = UpdatedComponent->GetComponentQuat();
+	if (!bIgnoreBaseRotation)
+	{
+		FinalQuat = DeltaQuat * FinalQuat;
+
+		// Pipe through ControlRotation, to affect camera.
+		if (CharacterOwner->Controller)
+		{
+			FRotator FinalRotation = FinalQuat.Rotator();
+			UpdateBasedRotation(FinalRotation, DeltaQuat.Rotator());
+			FinalQuat = FinalRotation.Quaternion();
+		}
+
+		if (IsMovingOnGround())
+		{
+			Velocity = DeltaQuat.RotateVector(Velocity);
+		}
+	}
+
+	if (bFastAttachedMove)
+	{
+		// We're trusting no other obstacle can prevent the move here.
+		UpdatedComponent->SetWorldLocationAndRotation(OldLocation + DeltaPosition, FinalQuat, false);
+	}
+	else
+	{
+		FHitResult MoveOnBaseHit(1.0f);
+		MoveUpdatedComponent(DeltaPosition, FinalQuat, true, &MoveOnBaseHit);
+		if (!((UpdatedComponent->GetComponentLocation() - (OldLocation + DeltaPosition)).IsNearlyZero()))
+		{
+			OnUnableToFollowBaseMove(DeltaPosition, OldLocation, MoveOnBaseHit);
+		}
+	}
+
+	OldRotatingBaseAngle = SpinAngle;
+}
+
+void UALSCharacterMovementComponent::UpdateCentrifugalGravity()
+{
+	if (!CharacterMovementCVars::CentrifugalGravity)
+	{
+		CentrifugalGravityBase = nullptr;
+		return;
+	}
+
+	// Falling off a spinning section keeps its gravity until we land somewhere else
+	const UPrimitiveComponent* MovementBase = CharacterOwner->GetMovementBase();
+	if (MovementBase)
+	{
+		UALSRotatingBaseComponent* RotatingBase = GetRotatingBase(MovementBase);
+		CentrifugalGravityBase = RotatingBase && RotatingBase->bCentrifugalGravity ? RotatingBase : nullptr;
+	}
+	else if (!IsFalling())
+	{
+		CentrifugalGravityBase = nullptr;
+	}
+
+	const UALSRotatingBaseComponent* GravityBase = CentrifugalGravityBase.Get();
+	FVector GravityDirection;
+	float GravityAcceleration;
+	if (GravityBase && GravityBase->GetCentrifugalGravity(UpdatedComponent->GetComponentLocation(), GravityDirection, GravityAcceleration))
+	{
+		ApplyMoveGravityAcceleration(GravityDirection, GravityAcceleration);
+	}
+}
+
+void UALSCharacterMovementComponent::UpdateFieldGravity()
+{
+	UALSGravityFieldSubsystem* GravityField = bUseGravityField ? UALSGravityFieldSubsystem::Get(this) : nullptr;
+
+	// Outside every source the gravity set from outside, e.g. by SetGravityDirection, stays in charge
+	FVector FieldGravity;
+	if (!GravityField || !GravityField->HasSources() ||
+		!GravityField->SampleGravity(UpdatedComponent->GetComponentLocation(), FieldGravity))
+	{
+		RestoreExternalGravity();
+		return;
+	}
+
+	// Remember what the field takes over from, so leaving it gives the designer's gravity back
+	if (!bFieldGravityActive)
+	{
+		bFieldGravityActive = true;
+		ExternalGravityDirection = CustomGravityDirection;
+		ExternalGravityScale = GravityScale;
+	}
+
+	// Mantles and other root motion finish in the mode they started in
+	const bool bCanChangeMode = !HasRootMotionSources();
+	const float FieldAcceleration = FieldGravity.Size();
+	if (FieldAcceleration < KINDA_SMALL_NUMBER)
+	{
+		if (bCanChangeMode && !IsInZeroGravity())
+		{
+			SetGravityDirection(FVector::ZeroVector);
+		}
+		return;
+	}
+
+	const FVector FieldDirection = FieldGravity / FieldAcceleration;
+	if (bCanChangeMode && IsInZeroGravity())
+	{
+		SetGravityDirection(FieldDirection);
+	}
+
+	ApplyMoveGravityAcceleration(FieldDirection, FieldAcceleration);
+}
+
+void UALSCharacterMovementComponent::RestoreExternalGravity()
+{
+	if (!bFieldGravityActive || HasRootMotionSources())
+	{
+		return;
+	}
+
+	bFieldGravityActive = false;
+
+	// Through SetGravityDirection so a field that left us weightless hands back the mode too
+	if (ExternalGravityDirection.IsZero() != IsInZeroGravity())
+	{
+		SetGravityDirection(ExternalGravityDirection);
 	}
+
+	ApplyMoveGravity(ExternalGravityDirection, ExternalGravityScale);
+}
+
+void UALSCharacterMovementComponent::ApplyMoveGravityAcceleration(const FVector& Direction, float Acceleration)
+{
+	// GetGravity() scales the volume's gravity by GravityScale twice
+	const float WorldGravity = FMath::Abs(GetPhysicsVolume()->GetGravityZ());
+	ApplyMoveGravity(Direction, WorldGravity > KINDA_SMALL_NUMBER ? FMath::Sqrt(Acceleration / WorldGravity) : 1.0f);
 }
 
 bool UALSCharacterMovementComponent::DoJump(bool bReplayingMoves)
@@ -2006,8 +3147,121 @@ void UALSCharacterMovementComponent::JumpOff(AActor* MovementBaseActor)
 
 void UALSCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bZeroDelta, const FHitResult* DownwardSweepResult /*= NULL*/) const
 {
-	// This is broken for planets
+	// A supplied downward sweep is already cheaper than the cache bookkeeping
+	const bool bUseFloorCache = DownwardSweepResult == NULL;
+	if (bUseFloorCache && GetCachedFloor(CapsuleLocation, OutFloorResult))
+	{
+		return;
+	}
+
+	if (UsesWorldGravityFrame())
+	{
+		FindFloorImpl<FALSWorldGravityFrame>(CapsuleLocation, OutFloorResult, bZeroDelta, DownwardSweepResult);
+	}
+	else
+	{
+		FindFloorImpl<FALSCustomGravityFrame>(CapsuleLocation, OutFloorResult, bZeroDelta, DownwardSweepResult);
+	}
+
+	if (bUseFloorCache)
+	{
+		CacheFloor(CapsuleLocation, OutFloorResult);
+	}
+}
+
+bool UALSCharacterMovementComponent::GetCachedFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult) const
+{
+	if (!CharacterMovementCVars::FloorCacheEnabled || !FloorCache.bValid)
+	{
+		return false;
+	}
+
+	// Teleports and forced checks always sweep
+	if (bJustTeleported || bForceNextFloorCheck || !UpdatedComponent->IsCollisionEnabled())
+	{
+		FloorCache.bValid = false;
+		INC_DWORD_STAT(STAT_ALSFloorCacheMisses);
+		return false;
+	}
+
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+	const UPrimitiveComponent* Base = FloorCache.Base.Get();
+	const bool bKeyMatches = Base && !Base->IsPendingKill() &&
+		GetWorld()->GetTimeSeconds() - FloorCache.Time <= CharacterMovementCVars::FloorCacheMaxAge &&
+		IsMovingOnGround() == FloorCache.bMovingOnGround &&
+		PawnRadius == FloorCache.CapsuleRadius && PawnHalfHeight == FloorCache.CapsuleHalfHeight &&
+		GetFloorCacheGravityKey() == FloorCache.GravityKey &&
+		UpdatedComponent->GetComponentQuat().Equals(FloorCache.CapsuleRotation, KINDA_SMALL_NUMBER) &&
+		Base->GetComponentTransform().Equals(FloorCache.BaseTransform, KINDA_SMALL_NUMBER);
+	if (!bKeyMatches)
+	{
+		FloorCache.bValid = false;
+		INC_DWORD_STAT(STAT_ALSFloorCacheMisses);
+		return false;
+	}
+
+	// Exact location, or a small move over a flat floor where only the vertical offset changes the result
+	const FVector CapsuleLocationBS = FloorCache.BaseTransform.InverseTransformPosition(CapsuleLocation);
+	const FVector Offset = FloorCache.BaseTransform.TransformVector(CapsuleLocationBS - FloorCache.CapsuleLocationBS);
+	if (Offset.IsZero())
+	{
+		OutFloorResult = FloorCache.Result;
+		INC_DWORD_STAT(STAT_ALSFloorCacheHits);
+		return true;
+	}
+
+	const FVector CapsuleUp = GetCapsuleAxisZ();
+	const FHitResult& FloorHit = FloorCache.Result.HitResult;
+	if (FloorCache.Result.bWalkableFloor && (FloorHit.ImpactNormal | CapsuleUp) >= THRESH_NORMALS_ARE_PARALLEL &&
+		Offset.SizeSquared() <= FMath::Square(CharacterMovementCVars::FloorCacheTolerance))
+	{
+		const float VerticalOffset = Offset | CapsuleUp;
+		OutFloorResult = FloorCache.Result;
+		OutFloorResult.FloorDist += VerticalOffset;
+		OutFloorResult.LineDist += VerticalOffset;
+		INC_DWORD_STAT(STAT_ALSFloorCacheHits);
+		return true;
+	}
+
+	INC_DWORD_STAT(STAT_ALSFloorCacheMisses);
+	return false;
+}
+
+void UALSCharacterMovementComponent::CacheFloor(const FVector& CapsuleLocation, const FFindFloorResult& FloorResult) const
+{
+	// Only floors on a component can be tracked for movement, no floor at all is swept every time
+	const UPrimitiveComponent* Base = FloorResult.HitResult.Component.Get();
+	if (!CharacterMovementCVars::FloorCacheEnabled || !FloorResult.bBlockingHit || !Base)
+	{
+		FloorCache.bValid = false;
+		return;
+	}
+
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(FloorCache.CapsuleRadius, FloorCache.CapsuleHalfHeight);
+	FloorCache.Base = Base;
+	FloorCache.BaseTransform = Base->GetComponentTransform();
+	FloorCache.CapsuleLocationBS = FloorCache.BaseTransform.InverseTransformPosition(CapsuleLocation);
+	FloorCache.CapsuleRotation = UpdatedComponent->GetComponentQuat();
+	FloorCache.GravityKey = GetFloorCacheGravityKey();
+	FloorCache.bMovingOnGround = IsMovingOnGround();
+	FloorCache.Time = GetWorld()->GetTimeSeconds();
+	FloorCache.Result = FloorResult;
+	FloorCache.bValid = true;
+}
+
+FIntVector UALSCharacterMovementComponent::GetFloorCacheGravityKey() const
+{
+	// Quantized so the float noise of a re-normalized direction doesn't throw the cache away
+	const FVector GravityDirection = GetGravityDirection() * 1024.0f;
+	return FIntVector(FMath::RoundToInt(GravityDirection.X), FMath::RoundToInt(GravityDirection.Y),
+	                  FMath::RoundToInt(GravityDirection.Z));
+}
 
+template <typename GravityFrame>
+void UALSCharacterMovementComponent::FindFloorImpl(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bZeroDelta, const FHitResult* DownwardSweepResult) const
+{
 	// No collision, no floor...
 	if (!UpdatedComponent->IsCollisionEnabled())
 	{
@@ -2030,7 +3284,7 @@ void UALSCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, F
 		if (bAlwaysCheckFloor || !bZeroDelta || bForceNextFloorCheck || bJustTeleported)
 		{
 			MutableThis->bForceNextFloorCheck = false;
-			ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+			ComputeFloorDistImpl<GravityFrame>(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
 		}
 		else
 		{
@@ -2057,7 +3311,7 @@ void UALSCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, F
 			else
 			{
 				MutableThis->bForceNextFloorCheck = false;
-				ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+				ComputeFloorDistImpl<GravityFrame>(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
 			}
 		}
 	}
@@ -2331,6 +3585,17 @@ bool UALSCharacterMovementComponent::CanStepUp(const FHitResult& Hit) const
 }
 
 bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVector& Delta, const FHitResult& Hit, struct UCharacterMovementComponent::FStepDownResult* OutStepDownResult /*= NULL*/)
+{
+	if (UsesWorldGravityFrame())
+	{
+		return StepUpImpl<FALSWorldGravityFrame>(GravDir, Delta, Hit, OutStepDownResult);
+	}
+
+	return StepUpImpl<FALSCustomGravityFrame>(GravDir, Delta, Hit, OutStepDownResult);
+}
+
+template <typename GravityFrame>
+bool UALSCharacterMovementComponent::StepUpImpl(const FVector& GravDir, const FVector& Delta, const FHitResult& Hit, FStepDownResult* OutStepDownResult)
 {
 	if (MaxStepHeight <= 0.0f || !CanStepUp(Hit))
 	{
@@ -2341,7 +3606,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 	float PawnRadius, PawnHalfHeight;
 	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
 
-	const FVector CapsuleDown = GetCapsuleAxisZ() * -1.0f;
+	const FVector CapsuleDown = GravityFrame::GetCapsuleUp(GetCapsuleRotation()) * -1.0f;
 
 	// Get the axis of the capsule bounded by the following two end points.
 	const FVector BottomPoint = OldLocation + CapsuleDown * PawnHalfHeight;
@@ -2357,7 +3622,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 		return false;
 	}
 
-	const float StepSideZ = (Hit.ImpactNormal | GravDir) * -1.0f;
+	const float StepSideZ = GravityFrame::DotAxis(Hit.ImpactNormal, GravDir) * -1.0f;
 	float StepTravelUpHeight = MaxStepHeight;
 	float StepTravelDownHeight = StepTravelUpHeight;
 	FVector PawnInitialFloorBase = OldLocation + CapsuleDown * PawnHalfHeight;
@@ -2371,7 +3636,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 		StepTravelUpHeight = FMath::Max(StepTravelUpHeight - FloorDist, 0.0f);
 		StepTravelDownHeight = (MaxStepHeight + MAX_FLOOR_DIST * 2.0f);
 
-		const bool bHitVerticalFace = !IsWithinEdgeTolerance(Hit.Location, Hit.ImpactPoint, PawnRadius);
+		const bool bHitVerticalFace = !IsWithinEdgeToleranceNew<GravityFrame>(Hit.Location, CapsuleDown, Hit.ImpactPoint, PawnRadius);
 		if (!CurrentFloor.bLineTrace && !bHitVerticalFace)
 		{
 			PawnFloorPoint = CurrentFloor.HitResult.ImpactPoint;
@@ -2453,7 +3718,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 	if (SweepHit.IsValidBlockingHit())
 	{
 		// See if this step sequence would have allowed us to travel higher than our max step height allows.
-		const float DeltaZ = (PawnFloorPoint - SweepHit.ImpactPoint) | CapsuleDown;
+		const float DeltaZ = GravityFrame::DotAxis(PawnFloorPoint - SweepHit.ImpactPoint, CapsuleDown);
 		if (DeltaZ > MaxStepHeight)
 		{
 			ScopedStepUpMovement.RevertMove();
@@ -2473,7 +3738,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 
 			// Also reject if we would end up being higher than our starting location by stepping down.
 			// It's fine to step down onto an unwalkable normal below us, we will just slide off. Rejecting those moves would prevent us from being able to walk off the edge.
-			if (((OldLocation - SweepHit.Location) | CapsuleDown) > 0.0f)
+			if (GravityFrame::DotAxis(OldLocation - SweepHit.Location, CapsuleDown) > 0.0f)
 			{
 				ScopedStepUpMovement.RevertMove();
 				return false;
@@ -2481,7 +3746,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 		}
 
 		// Reject moves where the downward sweep hit something very close to the edge of the capsule. This maintains consistency with FindFloor as well.
-		if (!IsWithinEdgeTolerance(SweepHit.Location, SweepHit.ImpactPoint, PawnRadius))
+		if (!IsWithinEdgeToleranceNew<GravityFrame>(SweepHit.Location, CapsuleDown, SweepHit.ImpactPoint, PawnRadius))
 		{
 			ScopedStepUpMovement.RevertMove();
 			return false;
@@ -2501,7 +3766,7 @@ bool UALSCharacterMovementComponent::StepUp(const FVector& GravDir, const FVecto
 
 			// Reject unwalkable normals if we end up higher than our initial height.
 			// It's fine to walk down onto an unwalkable surface, don't reject those moves.
-			if (((OldLocation - SweepHit.Location) | CapsuleDown) > 0.0f)
+			if (GravityFrame::DotAxis(OldLocation - SweepHit.Location, CapsuleDown) > 0.0f)
 			{
 				// We should reject the floor result if we are trying to step up an actual step where we are not able to perch (this is rare).
 				// In those cases we should instead abort the step up and try to slide along the stair.
@@ -2668,6 +3933,33 @@ FVector UALSCharacterMovementComponent::GetLedgeMove(const FVector& OldLocation,
 		return FVector::ZeroVector;
 	}
 
+	if (UsesAsyncMovementQueries())
+	{
+		FVector SideStep;
+		if (ConsumeAsyncLedgeProbe(OldLocation, Delta, GravDir, SideStep))
+		{
+			return SideStep;
+		}
+
+		// Still requested means last frame's probe didn't fit in the sweep budget. Under load that can go on for many
+		// frames, so only hold at the ledge when the probe is actually on its way
+		const bool bPreviousProbeSkipped = AsyncLedgeProbe.bRequested;
+
+		AsyncLedgeProbe.bRequested = true;
+		AsyncLedgeProbe.OldLocation = OldLocation;
+		AsyncLedgeProbe.Delta = Delta;
+		AsyncLedgeProbe.GravDir = GravDir;
+		INC_DWORD_STAT(STAT_ALSAsyncLedgeProbesRequested);
+
+		if (!bPreviousProbeSkipped)
+		{
+			// Hold at the ledge until the sweeps issued at the end of this frame come back
+			return FVector::ZeroVector;
+		}
+
+		INC_DWORD_STAT(STAT_ALSAsyncLedgeProbesSkipped);
+	}
+
 	FVector SideDir = FVector::VectorPlaneProject(Delta, GravDir);
 
 	// Try left.
@@ -2687,6 +3979,196 @@ FVector UALSCharacterMovementComponent::GetLedgeMove(const FVector& OldLocation,
 	return FVector::ZeroVector;
 }
 
+bool UALSCharacterMovementComponent::UsesAsyncMovementQueries() const
+{
+	return bUseAsyncMovementQueries && CharacterMovementCVars::AsyncMovementQueries && CharacterOwner &&
+		CharacterOwner->HasAuthority() && CharacterOwner->GetController() && !CharacterOwner->IsPlayerControlled();
+}
+
+int32 UALSCharacterMovementComponent::IssueAsyncMovementQueries(int32 MaxSweeps)
+{
+	if (!HasValidData() || !UsesAsyncMovementQueries())
+	{
+		return 0;
+	}
+
+	UWorld* World = GetWorld();
+	const FQuat CapsuleRotation = GetCapsuleRotation();
+	const ECollisionChannel CollisionChannel = UpdatedComponent->GetCollisionObjectType();
+	int32 NumSweeps = 0;
+
+	// A character held at a ledge goes first, it doesn't move on until it has these
+	if (AsyncLedgeProbe.bRequested && MaxSweeps - NumSweeps >= 4)
+	{
+		static const FName CheckLedgeDirectionName(TEXT("CheckLedgeDirection"));
+		FCollisionQueryParams CapsuleParams(CheckLedgeDirectionName, false, CharacterOwner);
+		FCollisionResponseParams ResponseParam;
+		InitCollisionParams(CapsuleParams, ResponseParam);
+		const FCollisionShape CapsuleShape = GetPawnCapsuleCollisionShape(SHRINK_None);
+		const FVector& GravDir = AsyncLedgeProbe.GravDir;
+
+		// Left, then right, as GetLedgeMove tries them
+		const FVector SideDir = FQuat(GravDir, PI * 0.5f).RotateVector(FVector::VectorPlaneProject(AsyncLedgeProbe.Delta, GravDir));
+		AsyncLedgeProbe.SideSteps[0] = SideDir;
+		AsyncLedgeProbe.SideSteps[1] = SideDir * -1.0f;
+
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			const FVector SideDest = AsyncLedgeProbe.OldLocation + AsyncLedgeProbe.SideSteps[Side];
+			AsyncLedgeProbe.SideHandles[Side] = World->AsyncSweepByChannel(EAsyncTraceType::Single, AsyncLedgeProbe.OldLocation, SideDest, CapsuleRotation,
+				CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+			AsyncLedgeProbe.DownHandles[Side] = World->AsyncSweepByChannel(EAsyncTraceType::Single, SideDest, SideDest + GravDir * (MaxStepHeight + LedgeCheckThreshold),
+				CapsuleRotation, CollisionChannel, CapsuleShape, CapsuleParams, ResponseParam);
+		}
+
+		AsyncLedgeProbe.bRequested = false;
+		NumSweeps += 4;
+	}
+
+	// Flat base checks need a line trace after the sweep, those keep sweeping synchronously
+	if (IsMovingOnGround() && !bUseFlatBaseForFloorChecks && MaxSweeps - NumSweeps >= 1)
+	{
+		float PawnRadius, PawnHalfHeight;
+		CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+
+		// Same shrunk capsule as the first sweep of ComputeFloorDist, long enough for any FindFloor while walking
+		const float ShrinkScale = 0.9f;
+		const float ShrinkHeight = (PawnHalfHeight - PawnRadius) * (1.0f - ShrinkScale);
+		const float Tolerance = CharacterMovementCVars::AsyncMovementQueryTolerance;
+		const FVector CapsuleDown = GetCapsuleAxisZ() * -1.0f;
+
+		// Start from where the capsule should be next frame, raised so it still covers a capsule that ends up a bit higher
+		AsyncFloorProbe.Start = UpdatedComponent->GetComponentLocation() + Velocity * World->GetDeltaSeconds() - CapsuleDown * Tolerance;
+		AsyncFloorProbe.Down = CapsuleDown;
+		AsyncFloorProbe.Distance = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + MAX_FLOOR_DIST + KINDA_SMALL_NUMBER) + ShrinkHeight + Tolerance * 2.0f;
+		AsyncFloorProbe.Shape = FCollisionShape::MakeCapsule(PawnRadius, PawnHalfHeight - ShrinkHeight);
+
+		static const FName ComputeFloorDistName(TEXT("ComputeFloorDistSweep"));
+		FCollisionQueryParams QueryParams(ComputeFloorDistName, false, CharacterOwner);
+		FCollisionResponseParams ResponseParam;
+		InitCollisionParams(QueryParams, ResponseParam);
+		AsyncFloorProbe.Handle = World->AsyncSweepByChannel(EAsyncTraceType::Single, AsyncFloorProbe.Start,
+			AsyncFloorProbe.Start + CapsuleDown * AsyncFloorProbe.Distance, CapsuleRotation, CollisionChannel, AsyncFloorProbe.Shape, QueryParams, ResponseParam);
+
+		++NumSweeps;
+	}
+
+	return NumSweeps;
+}
+
+bool UALSCharacterMovementComponent::ConsumeAsyncFloorProbe(const FVector& CapsuleLocation, const FVector& CapsuleDown, const FCollisionShape& CapsuleShape, float TraceDist, FHitResult& OutHit) const
+{
+	if (!AsyncFloorProbe.Handle.IsValid())
+	{
+		return false;
+	}
+
+	// Results only live for the frame after they were issued
+	FTraceDatum TraceData;
+	if (!GetWorld()->QueryTraceData(AsyncFloorProbe.Handle, TraceData))
+	{
+		AsyncFloorProbe.Handle = FTraceHandle();
+		INC_DWORD_STAT(STAT_ALSAsyncFloorProbesRejected);
+		return false;
+	}
+
+	// The capsule is symmetric around its axis, only the axis and the size have to match
+	const FVector Offset = CapsuleLocation - AsyncFloorProbe.Start;
+	const float VerticalOffset = Offset | CapsuleDown;
+	const FVector PlanarOffset = Offset - CapsuleDown * VerticalOffset;
+	if ((CapsuleDown | AsyncFloorProbe.Down) < THRESH_NORMALS_ARE_PARALLEL ||
+		!FMath::IsNearlyEqual(CapsuleShape.GetCapsuleRadius(), AsyncFloorProbe.Shape.GetCapsuleRadius()) ||
+		!FMath::IsNearlyEqual(CapsuleShape.GetCapsuleHalfHeight(), AsyncFloorProbe.Shape.GetCapsuleHalfHeight()) ||
+		VerticalOffset < 0.0f || PlanarOffset.SizeSquared() > FMath::Square(CharacterMovementCVars::AsyncMovementQueryTolerance))
+	{
+		INC_DWORD_STAT(STAT_ALSAsyncFloorProbesRejected);
+		return false;
+	}
+
+	const FHitResult* ProbeHit = TraceData.OutHits.Num() > 0 && TraceData.OutHits[0].bBlockingHit ? &TraceData.OutHits[0] : nullptr;
+	const FVector TraceEnd = CapsuleLocation + CapsuleDown * TraceDist;
+	if (!ProbeHit)
+	{
+		// Empty space is only known to be empty where the probe went
+		if (!PlanarOffset.IsNearlyZero() || VerticalOffset + TraceDist > AsyncFloorProbe.Distance)
+		{
+			INC_DWORD_STAT(STAT_ALSAsyncFloorProbesRejected);
+			return false;
+		}
+
+		OutHit = FHitResult(CapsuleLocation, TraceEnd);
+		INC_DWORD_STAT(STAT_ALSAsyncFloorProbesUsed);
+		return true;
+	}
+
+	// Off the probe axis the distance only carries over to a flat floor
+	const float HitDist = ProbeHit->Time * AsyncFloorProbe.Distance - VerticalOffset;
+	if (ProbeHit->bStartPenetrating || !ProbeHit->Component.IsValid() || HitDist < 0.0f || HitDist > TraceDist ||
+		(!PlanarOffset.IsNearlyZero() && (ProbeHit->ImpactNormal | CapsuleDown) > -THRESH_NORMALS_ARE_PARALLEL))
+	{
+		INC_DWORD_STAT(STAT_ALSAsyncFloorProbesRejected);
+		return false;
+	}
+
+	OutHit = *ProbeHit;
+	OutHit.Time = TraceDist > 0.0f ? HitDist / TraceDist : 0.0f;
+	OutHit.Distance = HitDist;
+	OutHit.TraceStart = CapsuleLocation;
+	OutHit.TraceEnd = TraceEnd;
+	OutHit.Location = CapsuleLocation + CapsuleDown * HitDist;
+	OutHit.ImpactPoint += PlanarOffset;
+	INC_DWORD_STAT(STAT_ALSAsyncFloorProbesUsed);
+	return true;
+}
+
+bool UALSCharacterMovementComponent::ConsumeAsyncLedgeProbe(const FVector& OldLocation, const FVector& Delta, const FVector& GravDir, FVector& OutSideStep) const
+{
+	if (!AsyncLedgeProbe.SideHandles[0].IsValid())
+	{
+		return false;
+	}
+
+	// Only for the ledge the probe was issued for
+	const FVector DeltaDir = FVector::VectorPlaneProject(Delta, GravDir).GetSafeNormal();
+	const FVector ProbeDeltaDir = FVector::VectorPlaneProject(AsyncLedgeProbe.Delta, AsyncLedgeProbe.GravDir).GetSafeNormal();
+	if ((GravDir | AsyncLedgeProbe.GravDir) < THRESH_NORMALS_ARE_PARALLEL || (DeltaDir | ProbeDeltaDir) < THRESH_NORMALS_ARE_PARALLEL ||
+		FVector::DistSquared(OldLocation, AsyncLedgeProbe.OldLocation) > FMath::Square(CharacterMovementCVars::AsyncMovementQueryTolerance))
+	{
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	FTraceDatum SideData[2];
+	FTraceDatum DownData[2];
+	for (int32 Side = 0; Side < 2; ++Side)
+	{
+		if (!World->QueryTraceData(AsyncLedgeProbe.SideHandles[Side], SideData[Side]) ||
+			!World->QueryTraceData(AsyncLedgeProbe.DownHandles[Side], DownData[Side]))
+		{
+			AsyncLedgeProbe.SideHandles[0] = FTraceHandle();
+			return false;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_ALSAsyncLedgeProbesUsed);
+
+	// Same decision as CheckLedgeDirection, with the down sweep issued whether the side sweep hit or not
+	for (int32 Side = 0; Side < 2; ++Side)
+	{
+		const FHitResult* SideHit = SideData[Side].OutHits.Num() > 0 && SideData[Side].OutHits[0].bBlockingHit ? &SideData[Side].OutHits[0] : nullptr;
+		const FHitResult* DownHit = DownData[Side].OutHits.Num() > 0 && DownData[Side].OutHits[0].bBlockingHit ? &DownData[Side].OutHits[0] : nullptr;
+		const FHitResult* Result = SideHit ? SideHit : DownHit;
+		if (Result && Result->Time < 1.0f && IsWalkable(*Result))
+		{
+			OutSideStep = AsyncLedgeProbe.SideSteps[Side];
+			return true;
+		}
+	}
+
+	OutSideStep = FVector::ZeroVector;
+	return true;
+}
+
 void UALSCharacterMovementComponent::StartNewPhysics(float deltaTime, int32 Iterations)
 {
 	if ((deltaTime < MIN_TICK_TIME) || (Iterations >= MaxSimulationIterations) || !HasValidData())
@@ -2885,7 +4367,17 @@ void UALSCharacterMovementComponent::ApplyAccumulatedForces(float DeltaSeconds)
 	}
 	**/
 	
-	Velocity += PendingImpulseToApply + (PendingForceToApply * DeltaSeconds);
+	// Falling integrates the force together with gravity over the whole update, see PhysFallingImpl
+	FallingExternalAcceleration = FVector::ZeroVector;
+	if (IsFalling() && CharacterMovementCVars::AnalyticFalling)
+	{
+		FallingExternalAcceleration = PendingForceToApply;
+		Velocity += PendingImpulseToApply;
+	}
+	else
+	{
+		Velocity += PendingImpulseToApply + (PendingForceToApply * DeltaSeconds);
+	}
 	//Velocity += PendingImpulseToApply + (PendingForceToApply * DeltaSeconds);
 	
 	//Velocity += CharacterOwner->GetCapsuleComponent()->GetForwardVector() * 100.f ;
@@ -2908,6 +4400,64 @@ void UALSCharacterMovementComponent::AddForce(FVector Force)
 	}
 }
 
+FVector UALSCharacterMovementComponent::GetChannelForce(EALSForceChannel Channel) const
+{
+	const AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(CharacterOwner);
+	if (!Character || !UpdatedComponent)
+	{
+		return FVector::ZeroVector;
+	}
+
+	const FALSForceChannels& Channels = Character->ForceChannels;
+	switch (Channel)
+	{
+	case EALSForceChannel::Wind:
+	{
+		// Less push the faster we already ride along with the wind
+		const FVector WindDirection = SmoothedWindForce.GetSafeNormal();
+		const float VelocityDot = WindDirection | Velocity.GetSafeNormal();
+		return SmoothedWindForce - (Velocity.Size() * WindDirection * FMath::Clamp(VelocityDot, 0.f, 1.f));
+	}
+	case EALSForceChannel::GravityWell:
+	{
+		if (Channels.WellStrength == 0.0f)
+		{
+			return FVector::ZeroVector;
+		}
+
+		const FVector ToWell = FVector(Channels.WellLocation) - UpdatedComponent->GetComponentLocation();
+		const float ForceScale = FMath::GetMappedRangeValueClamped({0.0f, Channels.WellRadius}, {1.0f, 0.f}, ToWell.Size());
+		return Channels.WellStrength * ForceScale * ToWell.GetSafeNormal();
+	}
+	case EALSForceChannel::Entanglement:
+		return Channels.EntanglementForce;
+	case EALSForceChannel::Scripted:
+		return Channels.ScriptedForce;
+	default:
+		return FVector::ZeroVector;
+	}
+}
+
+void UALSCharacterMovementComponent::ApplyForceChannels(float DeltaTime)
+{
+	const AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(CharacterOwner);
+	if (!Character)
+	{
+		return;
+	}
+
+	// Eased like the ragdoll's push, so the capsule and the ragdoll feel the same wind
+	SmoothedWindForce = UALSWindFieldSubsystem::SmoothForce(SmoothedWindForce, Character->WindFieldSample.Force, DeltaTime);
+
+	FVector ChannelForce = FVector::ZeroVector;
+	for (const EALSForceChannel Channel : {EALSForceChannel::Wind, EALSForceChannel::GravityWell, EALSForceChannel::Entanglement, EALSForceChannel::Scripted})
+	{
+		ChannelForce += GetChannelForce(Channel);
+	}
+
+	AddForce(ChannelForce);
+}
+
 bool UALSCharacterMovementComponent::IsWalkable(const FHitResult& Hit) const
 {
 	if (!Hit.IsValidBlockingHit())
@@ -2936,6 +4486,19 @@ bool UALSCharacterMovementComponent::IsWalkable(const FHitResult& Hit) const
 }
 
 void UALSCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult /*= NULL*/) const
+{
+	if (UsesWorldGravityFrame())
+	{
+		ComputeFloorDistImpl<FALSWorldGravityFrame>(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+	}
+	else
+	{
+		ComputeFloorDistImpl<FALSCustomGravityFrame>(CapsuleLocation, LineDistance, SweepDistance, OutFloorResult, SweepRadius, DownwardSweepResult);
+	}
+}
+
+template <typename GravityFrame>
+void UALSCharacterMovementComponent::ComputeFloorDistImpl(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const
 {
 	OutFloorResult.Clear();
 
@@ -2948,18 +4511,18 @@ void UALSCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoca
 	float PawnRadius, PawnHalfHeight;
 	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
 
-	const FVector CapsuleDown = GetCapsuleAxisZ() * -1.0f;
+	const FVector CapsuleDown = GravityFrame::GetCapsuleUp(GetCapsuleRotation()) * -1.0f;
 
 	bool bSkipSweep = false;
 	if (DownwardSweepResult != NULL && DownwardSweepResult->IsValidBlockingHit())
 	{
-		const float Dot = CapsuleDown | ((DownwardSweepResult->TraceEnd - DownwardSweepResult->TraceStart).GetSafeNormal());
+		const float Dot = GravityFrame::DotAxis((DownwardSweepResult->TraceEnd - DownwardSweepResult->TraceStart).GetSafeNormal(), CapsuleDown);
 
 		// Only if the supplied sweep was vertical and downward.
 		if (Dot >= THRESH_NORMALS_ARE_PARALLEL)
 		{
 			// Reject hits that are barely on the cusp of the radius of the capsule.
-			if (IsWithinEdgeToleranceNew(DownwardSweepResult->Location, CapsuleDown, DownwardSweepResult->ImpactPoint, PawnRadius))
+			if (IsWithinEdgeToleranceNew<GravityFrame>(DownwardSweepResult->Location, CapsuleDown, DownwardSweepResult->ImpactPoint, PawnRadius))
 			{
 				// Don't try a redundant sweep, regardless of whether this sweep is usable.
 				bSkipSweep = true;
@@ -3005,13 +4568,20 @@ void UALSCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoca
 		FCollisionShape CapsuleShape = FCollisionShape::MakeCapsule(SweepRadius, PawnHalfHeight - ShrinkHeight);
 
 		FHitResult Hit(1.0f);
-		bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + CapsuleDown * TraceDist, CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
+		if (ConsumeAsyncFloorProbe(CapsuleLocation, CapsuleDown, CapsuleShape, TraceDist, Hit))
+		{
+			bBlockingHit = Hit.bBlockingHit;
+		}
+		else
+		{
+			bBlockingHit = FloorSweepTest(Hit, CapsuleLocation, CapsuleLocation + CapsuleDown * TraceDist, CollisionChannel, CapsuleShape, QueryParams, ResponseParam);
+		}
 
 		if (bBlockingHit)
 		{
 			// Reject hits adjacent to us, we only care about hits on the bottom portion of our capsule.
 			// Check 2D distance to impact point, reject if within a tolerance from radius.
-			if (Hit.bStartPenetrating || !IsWithinEdgeToleranceNew(CapsuleLocation, CapsuleDown, Hit.ImpactPoint, CapsuleShape.Capsule.Radius))
+			if (Hit.bStartPenetrating || !IsWithinEdgeToleranceNew<GravityFrame>(CapsuleLocation, CapsuleDown, Hit.ImpactPoint, CapsuleShape.Capsule.Radius))
 			{
 				// Use a capsule with a slightly smaller radius and shorter height to avoid the adjacent object.
 				ShrinkHeight = (PawnHalfHeight - PawnRadius) * (1.0f - ShrinkScaleOverlap);
@@ -3083,12 +4653,12 @@ void UALSCharacterMovementComponent::ComputeFloorDist(const FVector& CapsuleLoca
 
 bool UALSCharacterMovementComponent::IsWithinEdgeTolerance(const FVector& CapsuleLocation, const FVector& TestImpactPoint, const float CapsuleRadius) const
 {
-	const FVector CapsuleDown = GetCapsuleAxisZ() * -1.0f;
-
-	const float DistFromCenterSq = (CapsuleLocation + CapsuleDown * ((TestImpactPoint - CapsuleLocation) | CapsuleDown) - TestImpactPoint).SizeSquared();
-	const float ReducedRadiusSq = FMath::Square(FMath::Max(KINDA_SMALL_NUMBER, CapsuleRadius - SWEEP_EDGE_REJECT_DISTANCE));
+	if (UsesWorldGravityFrame())
+	{
+		return IsWithinEdgeToleranceNew<FALSWorldGravityFrame>(CapsuleLocation, FVector::DownVector, TestImpactPoint, CapsuleRadius);
+	}
 
-	return DistFromCenterSq < ReducedRadiusSq;
+	return IsWithinEdgeToleranceNew<FALSCustomGravityFrame>(CapsuleLocation, GetCapsuleAxisZ() * -1.0f, TestImpactPoint, CapsuleRadius);
 }
 
 
@@ -3128,7 +4698,7 @@ void UALSCharacterMovementComponent::UpdateComponentRotationSmooth(float Delta)
 
 		const FVector DesiredCapsuleUp = GetComponentDesiredAxisZ();
 
-		if ((DesiredCapsuleUp | GetCapsuleAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL || ForceZeroG)
+		if ((DesiredCapsuleUp | GetCapsuleAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL || IsInZeroGravity())
 		{
 			return;
 		}
@@ -3149,7 +4719,7 @@ void UALSCharacterMovementComponent::UpdateComponentRotation()
 
 	const FVector DesiredCapsuleUp = GetComponentDesiredAxisZ();
 
-	if ((DesiredCapsuleUp | GetCapsuleAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL || ForceZeroG)
+	if ((DesiredCapsuleUp | GetCapsuleAxisZ()) >= THRESH_NORMALS_ARE_PARALLEL || IsInZeroGravity())
 	{
 		return;
 	}
@@ -3189,12 +4759,7 @@ inline FVector UALSCharacterMovementComponent::GetCapsuleAxisX() const
 
 inline FVector UALSCharacterMovementComponent::GetCapsuleAxisZ() const
 {
-	// Fast simplification of FQuat::RotateVector() with FVector(0,0,1).
-	const FQuat CapsuleRotation = GetCapsuleRotation();
-	const FVector QuatVector(CapsuleRotation.X, CapsuleRotation.Y, CapsuleRotation.Z);
-
-	return FVector(CapsuleRotation.Y * CapsuleRotation.W * 2.0f, CapsuleRotation.X * CapsuleRotation.W * -2.0f,
-		FMath::Square(CapsuleRotation.W) - QuatVector.SizeSquared()) + QuatVector * (CapsuleRotation.Z * 2.0f);
+	return FALSCustomGravityFrame::GetCapsuleUp(GetCapsuleRotation());
 }
 
 // Version that does not use inverse sqrt estimate, for higher precision.
@@ -3211,14 +4776,107 @@ inline FVector UALSCharacterMovementComponent::GetSafeNormalPrecise(const FVecto
 	}
 }
 
+template <typename GravityFrame>
 bool UALSCharacterMovementComponent::IsWithinEdgeToleranceNew(const FVector& CapsuleLocation, const FVector& CapsuleDown, const FVector& TestImpactPoint, const float CapsuleRadius) const
 {
-	const float DistFromCenterSq = (CapsuleLocation + CapsuleDown * ((TestImpactPoint - CapsuleLocation) | CapsuleDown) - TestImpactPoint).SizeSquared();
+	const float DistFromCenterSq = GravityFrame::ProjectOntoPlane(TestImpactPoint - CapsuleLocation, CapsuleDown).SizeSquared();
 	const float ReducedRadiusSq = FMath::Square(FMath::Max(KINDA_SMALL_NUMBER, CapsuleRadius - SWEEP_EDGE_REJECT_DISTANCE));
 
 	return DistFromCenterSq < ReducedRadiusSq;
 }
 
+bool UALSCharacterMovementComponent::UsesWorldGravityFrame() const
+{
+	// The world frame drops the capsule axis entirely, so only take it when that gives the same answers
+	return CharacterMovementCVars::UseWorldGravityFrame != 0 && UpdatedComponent &&
+		(GetGravityDirection() | FVector::DownVector) >= WORLD_GRAVITY_FRAME_MIN_UP_Z &&
+		GetCapsuleAxisZ().Z >= WORLD_GRAVITY_FRAME_MIN_UP_Z;
+}
+
+#if !UE_BUILD_SHIPPING
+void UALSCharacterMovementComponent::BenchmarkGravityFrames(int32 Iterations)
+{
+	if (!HasValidData() || Iterations <= 0)
+	{
+		return;
+	}
+
+	// Every step starts from the same state, so both frames move the same capsule through the same world
+	const FVector StartLocation = UpdatedComponent->GetComponentLocation();
+	const FQuat StartRotation = UpdatedComponent->GetComponentQuat();
+	const FVector StartVelocity = Velocity;
+	const FVector StartAcceleration = Acceleration;
+	const FFindFloorResult StartFloor = CurrentFloor;
+	const EMovementMode StartMovementMode = MovementMode;
+	const uint8 StartCustomMovementMode = CustomMovementMode;
+	const bool bStartWorldFrame = UsesWorldGravityFrame();
+
+	auto ResetState = [&]()
+	{
+		UpdatedComponent->SetWorldLocationAndRotation(StartLocation, StartRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		Velocity = StartVelocity;
+		Acceleration = StartAcceleration;
+		CurrentFloor = StartFloor;
+		if (MovementMode != StartMovementMode || CustomMovementMode != StartCustomMovementMode)
+		{
+			SetMovementMode(StartMovementMode, StartCustomMovementMode);
+		}
+	};
+
+	const float StepTime = 1.0f / 60.0f;
+	const int32 SavedUseWorldGravityFrame = CharacterMovementCVars::UseWorldGravityFrame;
+	double FrameSeconds[2];
+	FVector FrameEndLocation[2];
+
+	// Custom frame first, then the world frame where it applies
+	for (int32 Frame = 0; Frame < 2; ++Frame)
+	{
+		CharacterMovementCVars::UseWorldGravityFrame = Frame;
+
+		const double StartSeconds = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			ResetState();
+			PerformMovementStep(StepTime);
+		}
+		FrameSeconds[Frame] = FPlatformTime::Seconds() - StartSeconds;
+		FrameEndLocation[Frame] = UpdatedComponent->GetComponentLocation();
+	}
+
+	CharacterMovementCVars::UseWorldGravityFrame = SavedUseWorldGravityFrame;
+	ResetState();
+
+	const FString Result = FString::Printf(
+		TEXT("%s: PerformMovement %s world frame %.3f us, custom frame %.3f us, results %s%s"),
+		*GetNameSafe(CharacterOwner), *UEnum::GetValueAsString(StartMovementMode),
+		FrameSeconds[1] * 1000000.0 / Iterations, FrameSeconds[0] * 1000000.0 / Iterations,
+		FrameEndLocation[0].Equals(FrameEndLocation[1], KINDA_SMALL_NUMBER) ? TEXT("match") : TEXT("differ"),
+		bStartWorldFrame ? TEXT("") : TEXT(" (not in the world frame, both timed the custom frame)"));
+
+	UE_LOG(LogCharacterMovement, Log, TEXT("%s"), *Result);
+	if (GEngine)
+	{
+		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 10.0f, FColor::Cyan, Result);
+	}
+}
+
+// Per character cost of a movement step in both gravity frames. Usage: ALS.GravityFrameBenchmark [Iterations]
+static FAutoConsoleCommandWithWorldAndArgs GALSGravityFrameBenchmarkCommand(
+	TEXT("ALS.GravityFrameBenchmark"),
+	TEXT("Times whole PerformMovement steps through the world and custom gravity frames for every ALS character, from the same start state. Args: [Iterations=1000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Iterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+		for (TObjectIterator<UALSCharacterMovementComponent> It; It; ++It)
+		{
+			if (It->GetWorld() == World)
+			{
+				It->BenchmarkGravityFrames(Iterations);
+			}
+		}
+	}));
+#endif
+
 void UALSCharacterMovementComponent::GravityControlRotation(FRotator Rotation)
 {
 
@@ -0,0 +1,233 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSFlowSolverSubsystem.h"
+
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Character/ALSRoomFlowReplicator.h"
+#include "Character/ALSWindFieldSubsystem.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flow Rooms Published"), STAT_ALSFlowRoomsPublished, STATGROUP_ALSMovement);
+
+namespace ALSFlowSolverCVars
+{
+	static float PublishInterval = 0.1f;
+	FAutoConsoleVariableRef CVarPublishInterval(
+		TEXT("ALS.FlowSolver.PublishInterval"),
+		PublishInterval,
+		TEXT("Seconds between publishing finished room flows and starting the solves of changed rooms."),
+		ECVF_Default);
+}
+
+void UALSFlowSolverSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UALSFlowSolverSubsystem::OnWorldPostActorTick);
+}
+
+void UALSFlowSolverSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+	// Blends still running must not call back into a subsystem that is gone
+	for (const TPair<int32, FALSFlowRoomState>& Pair : Rooms)
+	{
+		if (ARoomDataHelper* DataHelper = Pair.Value.SolvingInput.DataHelper.Get())
+		{
+			DataHelper->AsyncCompressedForcesDelegate.RemoveDynamic(this, &UALSFlowSolverSubsystem::OnFlowBlended);
+		}
+	}
+
+	Rooms.Reset();
+	Replicators.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSFlowSolverSubsystem* UALSFlowSolverSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSFlowSolverSubsystem>() : nullptr;
+}
+
+void UALSFlowSolverSubsystem::SetRoomInput(int32 RoomID, const FALSFlowSolveInput& Input)
+{
+	// Clients receive flow, they never solve it
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	// A blend in flight keeps its own copy of the input, the new one is picked up at the next publish
+	FALSFlowRoomState& State = Rooms.FindOrAdd(RoomID);
+	State.Input = Input;
+	State.bInputChanged = true;
+}
+
+void UALSFlowSolverSubsystem::SetRoomFlowGrid(int32 RoomID, const FVector& Origin, const FVector& CellSize,
+                                              const FIntVector& Dimensions, TArray<FVector> Forces)
+{
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FVector PublishedOrigin = Origin;
+	FVector PublishedCellSize = CellSize;
+
+	if (GetWorld()->GetNetMode() != NM_Standalone)
+	{
+		AALSRoomFlowReplicator*& Replicator = Replicators.FindOrAdd(RoomID);
+		if (!IsValid(Replicator))
+		{
+			Replicator = GetWorld()->SpawnActor<AALSRoomFlowReplicator>();
+		}
+
+		if (Replicator)
+		{
+			// Wind is predicted, so the server simulates with the quantized grid its clients decode
+			Replicator->SetFlow(RoomID, Origin, CellSize, Dimensions, Forces);
+			Replicator->DequantizeFlow(Forces);
+			PublishedOrigin = Replicator->GetOrigin();
+			PublishedCellSize = Replicator->GetCellSize();
+		}
+	}
+
+	if (UALSWindFieldSubsystem* WindField = UALSWindFieldSubsystem::Get(this))
+	{
+		WindField->SetRoomFlow(RoomID, PublishedOrigin, PublishedCellSize, Dimensions, MoveTemp(Forces));
+	}
+}
+
+void UALSFlowSolverSubsystem::RemoveRoom(int32 RoomID)
+{
+	// A blend still running for the room finds no state to write into and is dropped
+	Rooms.Remove(RoomID);
+
+	AALSRoomFlowReplicator* Replicator = nullptr;
+	if (Replicators.RemoveAndCopyValue(RoomID, Replicator) && IsValid(Replicator))
+	{
+		Replicator->Destroy();
+	}
+
+	if (UALSWindFieldSubsystem* WindField = UALSWindFieldSubsystem::Get(this))
+	{
+		WindField->ClearRoomFlow(RoomID);
+	}
+}
+
+bool UALSFlowSolverSubsystem::GetPublishedFlow(int32 RoomID, FCompressedForceArray& OutCompressedForces) const
+{
+	const FALSFlowRoomState* State = Rooms.Find(RoomID);
+	if (!State || !State->bHasResult)
+	{
+		return false;
+	}
+
+	OutCompressedForces = State->Buffers[State->FrontBuffer];
+	return true;
+}
+
+void UALSFlowSolverSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || Rooms.Num() == 0)
+	{
+		return;
+	}
+
+	TimeSinceLastPublish += DeltaSeconds;
+	if (TimeSinceLastPublish < ALSFlowSolverCVars::PublishInterval)
+	{
+		return;
+	}
+
+	TimeSinceLastPublish = 0.0f;
+	Publish();
+}
+
+void UALSFlowSolverSubsystem::Publish()
+{
+	for (TPair<int32, FALSFlowRoomState>& Pair : Rooms)
+	{
+		const int32 RoomID = Pair.Key;
+		FALSFlowRoomState& State = Pair.Value;
+
+		if (State.bSolving)
+		{
+			// Not done yet, the front buffer stays published until the next publish
+			if (!State.bSolved)
+			{
+				continue;
+			}
+
+			State.bSolving = false;
+			State.bSolved = false;
+			State.FrontBuffer = 1 - State.FrontBuffer;
+			State.bHasResult = true;
+
+			// The helper's CompressedForceArray is left alone, writing it would resend the whole array to every
+			// client. The grid goes out through the room's replicator, only the chunks that changed
+			const FCompressedForceArray& CompressedForces = State.Buffers[State.FrontBuffer];
+			TArray<FVector> Forces;
+			if (DecodeFlow(CompressedForces, State.SolvingInput.Dimensions, Forces))
+			{
+				SetRoomFlowGrid(RoomID, State.SolvingInput.Origin, State.SolvingInput.CellSize,
+				                State.SolvingInput.Dimensions, MoveTemp(Forces));
+			}
+
+			OnFlowPublished.Broadcast(RoomID, CompressedForces);
+			INC_DWORD_STAT(STAT_ALSFlowRoomsPublished);
+		}
+
+		ARoomDataHelper* DataHelper = State.Input.DataHelper.Get();
+		if (State.bInputChanged && DataHelper)
+		{
+			State.bInputChanged = false;
+			State.SolvingInput = State.Input;
+			State.bSolving = true;
+
+			// The helper's own blend, the one clients used to run, on its background task
+			DataHelper->AsyncCompressedForcesDelegate.AddUniqueDynamic(this, &UALSFlowSolverSubsystem::OnFlowBlended);
+			DataHelper->CaclulateFlowBlendAsync(State.SolvingInput.AirCurrentData);
+		}
+	}
+}
+
+bool UALSFlowSolverSubsystem::DecodeFlow(const FCompressedForceArray& CompressedForces, const FIntVector& Dimensions,
+                                         TArray<FVector>& OutForces)
+{
+	const int32 NumPoints = Dimensions.X * Dimensions.Y * Dimensions.Z;
+	if (Dimensions.X <= 0 || Dimensions.Y <= 0 || Dimensions.Z <= 0 || CompressedForces.Forces.Num() < NumPoints)
+	{
+		return false;
+	}
+
+	// The helper blends straight onto the grid, one force per point in the same order
+	OutForces.Reset(NumPoints);
+	for (int32 Index = 0; Index < NumPoints; ++Index)
+	{
+		OutForces.Add(FVector(CompressedForces.Forces[Index]));
+	}
+
+	return true;
+}
+
+void UALSFlowSolverSubsystem::OnFlowBlended(const FCompressedForceArray& CompressedForces, ARoomDataHelper* DataHelper)
+{
+	for (TPair<int32, FALSFlowRoomState>& Pair : Rooms)
+	{
+		FALSFlowRoomState& State = Pair.Value;
+		if (State.bSolving && !State.bSolved && State.SolvingInput.DataHelper.Get() == DataHelper)
+		{
+			State.Buffers[1 - State.FrontBuffer] = CompressedForces;
+			State.bSolved = true;
+			return;
+		}
+	}
+}
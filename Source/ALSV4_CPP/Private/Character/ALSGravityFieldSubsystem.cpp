@@ -0,0 +1,314 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSGravityFieldSubsystem.h"
+
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Character/ALSGravitySourceComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gravity Field Sample"), STAT_ALSGravityFieldSample, STATGROUP_ALSMovement);
+DECLARE_CYCLE_STAT(TEXT("Gravity Field Rebuild"), STAT_ALSGravityFieldRebuild, STATGROUP_ALSMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gravity Sources"), STAT_ALSGravitySources, STATGROUP_ALSMovement);
+
+namespace ALSGravityFieldCVars
+{
+	static float CellSize = 2000.0f;
+	FAutoConsoleVariableRef CVarCellSize(
+		TEXT("ALS.GravityField.CellSize"),
+		CellSize,
+		TEXT("Size of the grid cells gravity sources are sorted into. Applies the next time a source registers or updates."),
+		ECVF_Default);
+
+	static int32 MaxCellsPerSource = 512;
+	FAutoConsoleVariableRef CVarMaxCellsPerSource(
+		TEXT("ALS.GravityField.MaxCellsPerSource"),
+		MaxCellsPerSource,
+		TEXT("Sources overlapping more cells than this, e.g. planets, are checked at every location instead of put in the grid."),
+		ECVF_Default);
+}
+
+void UALSGravityFieldSubsystem::Deinitialize()
+{
+	SourceComponents.Reset();
+	Sources.Reset();
+	Grid.Reset();
+	UnboundedSources.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSGravityFieldSubsystem* UALSGravityFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSGravityFieldSubsystem>() : nullptr;
+}
+
+void UALSGravityFieldSubsystem::RegisterSource(UALSGravitySourceComponent* Source)
+{
+	SourceComponents.AddUnique(Source);
+	bGridDirty = true;
+}
+
+void UALSGravityFieldSubsystem::UnregisterSource(UALSGravitySourceComponent* Source)
+{
+	SourceComponents.Remove(Source);
+	bGridDirty = true;
+}
+
+bool UALSGravityFieldSubsystem::SampleGravity(const FVector& Location, FVector& OutGravity)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSGravityFieldSample);
+
+	if (bGridDirty)
+	{
+		RebuildGrid();
+	}
+
+	return SampleSources(Grid.Find(GetCell(Location)), Location, OutGravity);
+}
+
+void UALSGravityFieldSubsystem::SampleGravityBatch(TArrayView<const FVector> Locations, TArrayView<FVector> OutGravity,
+                                                   TArrayView<bool> OutCovered)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSGravityFieldSample);
+	check(OutGravity.Num() >= Locations.Num() && OutCovered.Num() >= Locations.Num());
+
+	if (bGridDirty)
+	{
+		RebuildGrid();
+	}
+
+	FIntVector LastCell(MAX_int32);
+	const TArray<int32>* CellSources = nullptr;
+	for (int32 Index = 0; Index < Locations.Num(); ++Index)
+	{
+		const FIntVector Cell = GetCell(Locations[Index]);
+		if (Cell != LastCell)
+		{
+			LastCell = Cell;
+			CellSources = Grid.Find(Cell);
+		}
+
+		OutCovered[Index] = SampleSources(CellSources, Locations[Index], OutGravity[Index]);
+	}
+}
+
+void UALSGravityFieldSubsystem::RebuildGrid()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSGravityFieldRebuild);
+
+	bGridDirty = false;
+	CellSize = FMath::Max(ALSGravityFieldCVars::CellSize, 100.0f);
+	Sources.Reset();
+	Grid.Reset();
+	UnboundedSources.Reset();
+
+	SourceComponents.RemoveAll([](const TWeakObjectPtr<UALSGravitySourceComponent>& Component)
+	{
+		return !Component.IsValid();
+	});
+
+	for (const TWeakObjectPtr<UALSGravitySourceComponent>& Component : SourceComponents)
+	{
+		FALSGravitySource Source;
+		Source.Shape = Component->Shape;
+		Source.Transform = Component->GetComponentTransform();
+		Source.Transform.RemoveScaling();
+		Source.Axis = Source.Transform.GetUnitAxis(EAxis::Z);
+		Source.Strength = Component->Strength;
+		Source.Priority = Component->Priority;
+		Source.FalloffDistance = FMath::Max(Component->FalloffDistance, 1.0f);
+		Source.Radius = Component->Radius;
+		Source.HalfHeight = Component->HalfHeight;
+		Source.BoxExtent = Component->BoxExtent;
+		Source.bInvert = Component->bInvert;
+		Source.Spline = Component->Spline;
+
+		const FVector Center = Source.Transform.GetLocation();
+		const float Reach = Source.Radius + Source.FalloffDistance;
+		switch (Source.Shape)
+		{
+		case EALSGravitySourceShape::Point:
+			Source.Bounds = FBox(Center - FVector(Reach), Center + FVector(Reach));
+			break;
+		case EALSGravitySourceShape::Cylinder:
+		{
+			const FVector AxisReach = Source.Axis * (Source.HalfHeight + Source.FalloffDistance);
+			Source.Bounds = FBox(Center - AxisReach, Center + AxisReach).ExpandBy(Reach);
+			break;
+		}
+		case EALSGravitySourceShape::Box:
+		{
+			const FVector BoxReach = Source.BoxExtent + FVector(Source.FalloffDistance);
+			Source.Bounds = FBox(-BoxReach, BoxReach).TransformBy(Source.Transform);
+			break;
+		}
+		case EALSGravitySourceShape::Spline:
+			if (!Source.Spline.IsValid())
+			{
+				continue;
+			}
+			Source.Bounds = Source.Spline->CalcBounds(Source.Spline->GetComponentTransform()).GetBox().ExpandBy(Reach);
+			break;
+		}
+
+		const int32 SourceIndex = Sources.Add(Source);
+		const FIntVector MinCell = GetCell(Source.Bounds.Min);
+		const FIntVector MaxCell = GetCell(Source.Bounds.Max);
+		const int64 NumCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+		if (NumCells > ALSGravityFieldCVars::MaxCellsPerSource)
+		{
+			UnboundedSources.Add(SourceIndex);
+			continue;
+		}
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					Grid.FindOrAdd(FIntVector(X, Y, Z)).Add(SourceIndex);
+				}
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ALSGravitySources, Sources.Num());
+}
+
+FIntVector UALSGravityFieldSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize),
+	                  FMath::FloorToInt(Location.Z / CellSize));
+}
+
+bool UALSGravityFieldSubsystem::SampleSources(const TArray<int32>* CellSources, const FVector& Location,
+                                              FVector& OutGravity) const
+{
+	// Highest priority wins, sources sharing it add up
+	bool bCovered = false;
+	int32 BestPriority = MIN_int32;
+	OutGravity = FVector::ZeroVector;
+
+	auto SampleIndex = [&](int32 SourceIndex)
+	{
+		const FALSGravitySource& Source = Sources[SourceIndex];
+		if (bCovered && Source.Priority < BestPriority)
+		{
+			return;
+		}
+
+		FVector SourceGravity;
+		if (!SampleSource(Source, Location, SourceGravity))
+		{
+			return;
+		}
+
+		if (!bCovered || Source.Priority > BestPriority)
+		{
+			bCovered = true;
+			BestPriority = Source.Priority;
+			OutGravity = SourceGravity;
+		}
+		else
+		{
+			OutGravity += SourceGravity;
+		}
+	};
+
+	if (CellSources)
+	{
+		for (const int32 SourceIndex : *CellSources)
+		{
+			SampleIndex(SourceIndex);
+		}
+	}
+
+	for (const int32 SourceIndex : UnboundedSources)
+	{
+		SampleIndex(SourceIndex);
+	}
+
+	return bCovered;
+}
+
+bool UALSGravityFieldSubsystem::SampleSource(const FALSGravitySource& Source, const FVector& Location,
+                                             FVector& OutGravity) const
+{
+	if (!Source.Bounds.IsInsideOrOn(Location))
+	{
+		return false;
+	}
+
+	const FVector Center = Source.Transform.GetLocation();
+	FVector Direction;
+	float DistanceBeyond;
+
+	switch (Source.Shape)
+	{
+	case EALSGravitySourceShape::Point:
+	{
+		const FVector ToCenter = Center - Location;
+		const float Distance = ToCenter.Size();
+		if (Distance < KINDA_SMALL_NUMBER)
+		{
+			return false;
+		}
+		Direction = ToCenter / Distance;
+		DistanceBeyond = Distance - Source.Radius;
+		break;
+	}
+	case EALSGravitySourceShape::Cylinder:
+	{
+		const FVector Local = Location - Center;
+		const float Along = Local | Source.Axis;
+		const FVector Radial = Local - Source.Axis * Along;
+		const float Distance = Radial.Size();
+		if (Distance < KINDA_SMALL_NUMBER)
+		{
+			return false;
+		}
+		Direction = -Radial / Distance;
+		DistanceBeyond = FMath::Max(Distance - Source.Radius, FMath::Abs(Along) - Source.HalfHeight);
+		break;
+	}
+	case EALSGravitySourceShape::Box:
+	{
+		const FVector Local = Source.Transform.InverseTransformPositionNoScale(Location);
+		const FVector Outside = (Local.GetAbs() - Source.BoxExtent).ComponentMax(FVector::ZeroVector);
+		Direction = -Source.Axis;
+		DistanceBeyond = Outside.Size();
+		break;
+	}
+	case EALSGravitySourceShape::Spline:
+	{
+		const USplineComponent* Spline = Source.Spline.Get();
+		if (!Spline)
+		{
+			return false;
+		}
+		const float InputKey = Spline->FindInputKeyClosestToWorldLocation(Location);
+		const FVector Closest = Spline->GetLocationAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+		Direction = -Spline->GetUpVectorAtSplineInputKey(InputKey, ESplineCoordinateSpace::World);
+		DistanceBeyond = FVector::Dist(Location, Closest) - Source.Radius;
+		break;
+	}
+	default:
+		return false;
+	}
+
+	const float Weight = 1.0f - FMath::Max(DistanceBeyond, 0.0f) / Source.FalloffDistance;
+	if (Weight <= 0.0f)
+	{
+		return false;
+	}
+
+	OutGravity = (Source.bInvert ? -Direction : Direction) * Source.Strength * Weight;
+	return true;
+}
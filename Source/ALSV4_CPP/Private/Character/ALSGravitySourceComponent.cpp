@@ -0,0 +1,48 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#include "Character/ALSGravitySourceComponent.h"
+
+#include "Character/ALSGravityFieldSubsystem.h"
+#include "Components/SplineComponent.h"
+#include "GameFramework/Actor.h"
+
+UALSGravitySourceComponent::UALSGravitySourceComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UALSGravitySourceComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (!Spline && Shape == EALSGravitySourceShape::Spline && GetOwner())
+	{
+		Spline = GetOwner()->FindComponentByClass<USplineComponent>();
+	}
+
+	if (UALSGravityFieldSubsystem* GravityField = UALSGravityFieldSubsystem::Get(this))
+	{
+		GravityField->RegisterSource(this);
+	}
+}
+
+void UALSGravitySourceComponent::OnUnregister()
+{
+	if (UALSGravityFieldSubsystem* GravityField = UALSGravityFieldSubsystem::Get(this))
+	{
+		GravityField->UnregisterSource(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void UALSGravitySourceComponent::UpdateSource()
+{
+	if (UALSGravityFieldSubsystem* GravityField = UALSGravityFieldSubsystem::Get(this))
+	{
+		GravityField->RegisterSource(this);
+	}
+}
@@ -0,0 +1,265 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#include "Character/ALSHitboxHistoryComponent.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox Record"), STAT_ALSHitboxRecord, STATGROUP_ALSHitbox);
+DECLARE_CYCLE_STAT(TEXT("Hitbox Validate Shot"), STAT_ALSHitboxValidateShot, STATGROUP_ALSHitbox);
+
+UALSHitboxHistoryComponent::UALSHitboxHistoryComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Record after animation has produced the final pose of the frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UALSHitboxHistoryComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Only the server validates hits, clients never pay for the history
+	if (!GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	BuildHitboxes();
+	if (Hitboxes.Num() == 0)
+	{
+		return;
+	}
+
+	Snapshots.SetNum(HistoryDepth);
+	for (FALSHitboxSnapshot& Snapshot : Snapshots)
+	{
+		Snapshot.SegmentStarts.SetNumUninitialized(Hitboxes.Num());
+		Snapshot.SegmentEnds.SetNumUninitialized(Hitboxes.Num());
+	}
+
+	SetComponentTickInterval(1.0f / RecordRate);
+	SetComponentTickEnabled(true);
+}
+
+void UALSHitboxHistoryComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                               FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	RecordSnapshot();
+}
+
+void UALSHitboxHistoryComponent::BuildHitboxes()
+{
+	Hitboxes.Reset();
+
+	ACharacter* Character = Cast<ACharacter>(GetOwner());
+	Mesh = Character ? Character->GetMesh() : GetOwner()->FindComponentByClass<USkeletalMeshComponent>();
+	UPhysicsAsset* PhysicsAsset = Mesh ? Mesh->GetPhysicsAsset() : nullptr;
+	if (!PhysicsAsset)
+	{
+		return;
+	}
+
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+	{
+		const int32 BoneIndex = BodySetup ? Mesh->GetBoneIndex(BodySetup->BoneName) : INDEX_NONE;
+		if (BoneIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		// Bodies are authored in bone space, the bone's world scale (mesh and bone scale together) sizes them
+		const FVector Scale = Mesh->GetBoneTransform(BoneIndex).GetScale3D().GetAbs();
+		const float RadialScale = FMath::Max(Scale.X, Scale.Y);
+
+		for (const FKSphylElem& Sphyl : BodySetup->AggGeom.SphylElems)
+		{
+			FALSHitboxCapsule& Hitbox = Hitboxes.AddDefaulted_GetRef();
+			Hitbox.BoneIndex = BoneIndex;
+			Hitbox.LocalTransform = Sphyl.GetTransform();
+			Hitbox.Radius = Sphyl.Radius * RadialScale;
+			Hitbox.HalfLength = Sphyl.Length * 0.5f * Scale.Z;
+		}
+
+		for (const FKSphereElem& Sphere : BodySetup->AggGeom.SphereElems)
+		{
+			FALSHitboxCapsule& Hitbox = Hitboxes.AddDefaulted_GetRef();
+			Hitbox.BoneIndex = BoneIndex;
+			Hitbox.LocalTransform = FTransform(Sphere.Center);
+			Hitbox.Radius = Sphere.Radius * Scale.GetMax();
+		}
+
+		// Boxes become the capsule enclosing them, running along their Z axis. The segment spans the full height so the
+		// end caps cover the top and bottom corners too
+		for (const FKBoxElem& Box : BodySetup->AggGeom.BoxElems)
+		{
+			FALSHitboxCapsule& Hitbox = Hitboxes.AddDefaulted_GetRef();
+			Hitbox.BoneIndex = BoneIndex;
+			Hitbox.LocalTransform = Box.GetTransform();
+			Hitbox.Radius = 0.5f * FMath::Sqrt(FMath::Square(Box.X * Scale.X) + FMath::Square(Box.Y * Scale.Y));
+			Hitbox.HalfLength = 0.5f * Box.Z * Scale.Z;
+		}
+	}
+}
+
+void UALSHitboxHistoryComponent::RecordSnapshot()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSHitboxRecord);
+
+	if (!Mesh || Snapshots.Num() == 0)
+	{
+		return;
+	}
+
+	NewestSnapshot = (NewestSnapshot + 1) % Snapshots.Num();
+	NumSnapshots = FMath::Min(NumSnapshots + 1, Snapshots.Num());
+
+	FALSHitboxSnapshot& Snapshot = Snapshots[NewestSnapshot];
+	Snapshot.Time = GetWorld()->GetTimeSeconds();
+	Snapshot.Bounds.Init();
+
+	for (int32 Index = 0; Index < Hitboxes.Num(); ++Index)
+	{
+		const FALSHitboxCapsule& Hitbox = Hitboxes[Index];
+		const FTransform CapsuleTransform = Hitbox.LocalTransform * Mesh->GetBoneTransform(Hitbox.BoneIndex);
+		const FVector Center = CapsuleTransform.GetLocation();
+		const FVector HalfAxis = CapsuleTransform.GetUnitAxis(EAxis::Z) * Hitbox.HalfLength;
+
+		Snapshot.SegmentStarts[Index] = Center - HalfAxis;
+		Snapshot.SegmentEnds[Index] = Center + HalfAxis;
+		Snapshot.Bounds += FBox::BuildAABB(Center, FVector(Hitbox.HalfLength + Hitbox.Radius));
+	}
+}
+
+float UALSHitboxHistoryComponent::GetOldestRecordedTime() const
+{
+	if (NumSnapshots == 0)
+	{
+		return -1.0f;
+	}
+
+	const int32 Oldest = (NewestSnapshot - NumSnapshots + 1 + Snapshots.Num()) % Snapshots.Num();
+	return Snapshots[Oldest].Time;
+}
+
+bool UALSHitboxHistoryComponent::ValidateShot(const FVector& Start, const FVector& End, float Time,
+                                              float ShooterLatency) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSHitboxValidateShot);
+
+	if (NumSnapshots == 0)
+	{
+		return false;
+	}
+
+	// The client picks the time, so only a rewind its latency explains is allowed
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Time < Now - (FMath::Max(ShooterLatency, 0.0f) + RewindSlack))
+	{
+		return false;
+	}
+
+	Time = FMath::Min(Time, Now);
+
+	// Walk back from the newest snapshot to the pair bracketing the requested time.
+	// Times newer than the last record use the last record, older than the buffer can't be rewound to.
+	int32 Newer = NewestSnapshot;
+	int32 Older = NewestSnapshot;
+	for (int32 Step = 0; Step < NumSnapshots; ++Step)
+	{
+		const int32 Index = (NewestSnapshot - Step + Snapshots.Num()) % Snapshots.Num();
+		Older = Index;
+		if (Snapshots[Index].Time <= Time)
+		{
+			break;
+		}
+		Newer = Index;
+	}
+
+	const FALSHitboxSnapshot& OlderSnapshot = Snapshots[Older];
+	const FALSHitboxSnapshot& NewerSnapshot = Snapshots[Newer];
+	if (Time < OlderSnapshot.Time - 1.0f / RecordRate)
+	{
+		return false;
+	}
+
+	const float TimeRange = NewerSnapshot.Time - OlderSnapshot.Time;
+	const float Alpha = TimeRange > SMALL_NUMBER ? FMath::Clamp((Time - OlderSnapshot.Time) / TimeRange, 0.0f, 1.0f) : 0.0f;
+
+	// Cheap reject against both poses' bounds before touching any capsule
+	const FBox Bounds = (OlderSnapshot.Bounds + NewerSnapshot.Bounds).ExpandBy(HitLeeway);
+	if (!FMath::LineBoxIntersection(Bounds, Start, End, End - Start))
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < Hitboxes.Num(); ++Index)
+	{
+		const FVector SegmentStart = FMath::Lerp(OlderSnapshot.SegmentStarts[Index], NewerSnapshot.SegmentStarts[Index], Alpha);
+		const FVector SegmentEnd = FMath::Lerp(OlderSnapshot.SegmentEnds[Index], NewerSnapshot.SegmentEnds[Index], Alpha);
+
+		FVector ShotPoint;
+		FVector HitboxPoint;
+		FMath::SegmentDistToSegmentSafe(Start, End, SegmentStart, SegmentEnd, ShotPoint, HitboxPoint);
+		if (FVector::DistSquared(ShotPoint, HitboxPoint) <= FMath::Square(Hitboxes[Index].Radius + HitLeeway))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#if !UE_BUILD_SHIPPING
+// Measures the validation cost per shot against every recorded history in the world.
+// Usage: ALS.HitboxBenchmark [Shots]
+static FAutoConsoleCommandWithWorldAndArgs GALSHitboxBenchmarkCommand(
+	TEXT("ALS.HitboxBenchmark"),
+	TEXT("Times UALSHitboxHistoryComponent::ValidateShot against every recorded history. Args: [Shots=10000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumShots = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10000;
+		FRandomStream RandomStream(0);
+
+		for (TObjectIterator<UALSHitboxHistoryComponent> It; It; ++It)
+		{
+			const UALSHitboxHistoryComponent* History = *It;
+			const float OldestTime = History->GetOldestRecordedTime();
+			if (History->GetWorld() != World || OldestTime < 0.0f)
+			{
+				continue;
+			}
+
+			// Shots from a ring around the owner, aimed at a random point near it and a random time in the buffer
+			const FVector Center = History->GetOwner()->GetActorLocation();
+			const float NewestTime = World->GetTimeSeconds();
+			int32 NumHits = 0;
+
+			const double StartSeconds = FPlatformTime::Seconds();
+			for (int32 Shot = 0; Shot < NumShots; ++Shot)
+			{
+				const FVector Start = Center + RandomStream.GetUnitVector() * 1000.0f;
+				const FVector Target = Center + RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, 100.0f);
+				const FVector End = Start + (Target - Start) * 1.5f;
+				const float Time = RandomStream.FRandRange(OldestTime, NewestTime);
+				// A latency covering the whole buffer, so every shot gets to the hitboxes
+				NumHits += History->ValidateShot(Start, End, Time, NewestTime - OldestTime) ? 1 : 0;
+			}
+			const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+			UE_LOG(LogTemp, Log, TEXT("%s: %d hitboxes, %d shots, %d hits, %.3f us per shot"),
+			       *GetNameSafe(History->GetOwner()), History->GetNumHitboxes(), NumShots, NumHits,
+			       ElapsedSeconds * 1000000.0 / NumShots);
+		}
+	}));
+#endif
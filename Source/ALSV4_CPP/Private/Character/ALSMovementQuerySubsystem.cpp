@@ -0,0 +1,78 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSMovementQuerySubsystem.h"
+
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Sweeps Issued"), STAT_ALSAsyncSweepsIssued, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Queries Over Budget"), STAT_ALSAsyncQueriesOverBudget, STATGROUP_ALSMovement);
+
+namespace ALSMovementQueryCVars
+{
+	static int32 MaxSweeps = 64;
+	FAutoConsoleVariableRef CVarMaxSweeps(
+		TEXT("ALS.AsyncMovementQueries.MaxSweeps"),
+		MaxSweeps,
+		TEXT("Async floor and ledge sweeps issued per frame for all AI characters of a world."),
+		ECVF_Default);
+}
+
+void UALSMovementQuerySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UALSMovementQuerySubsystem::OnWorldPostActorTick);
+}
+
+void UALSMovementQuerySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	QueuedComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSMovementQuerySubsystem* UALSMovementQuerySubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSMovementQuerySubsystem>() : nullptr;
+}
+
+void UALSMovementQuerySubsystem::QueueQueries(UALSCharacterMovementComponent* MovementComponent)
+{
+	QueuedComponents.AddUnique(MovementComponent);
+}
+
+void UALSMovementQuerySubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || QueuedComponents.Num() == 0)
+	{
+		return;
+	}
+
+	int32 SweepBudget = ALSMovementQueryCVars::MaxSweeps;
+	const int32 NumQueued = QueuedComponents.Num();
+	const int32 StartIndex = FirstQueued % NumQueued;
+	int32 NumIssued = 0;
+	for (; NumIssued < NumQueued && SweepBudget > 0; ++NumIssued)
+	{
+		UALSCharacterMovementComponent* MovementComponent = QueuedComponents[(StartIndex + NumIssued) % NumQueued].Get();
+		if (MovementComponent && !MovementComponent->IsPendingKill())
+		{
+			const int32 NumSweeps = MovementComponent->IssueAsyncMovementQueries(SweepBudget);
+			SweepBudget -= NumSweeps;
+			INC_DWORD_STAT_BY(STAT_ALSAsyncSweepsIssued, NumSweeps);
+		}
+	}
+
+	// Whoever didn't get a turn goes first next frame
+	INC_DWORD_STAT_BY(STAT_ALSAsyncQueriesOverBudget, NumQueued - NumIssued);
+	FirstQueued = StartIndex + NumIssued;
+	QueuedComponents.Reset();
+}
@@ -0,0 +1,527 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSReplicationGraph.h"
+
+#include "Character/ALSBaseCharacter.h"
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Character/ALSRoomFlowReplicator.h"
+#include "Character/ALSRoomStreamingSubsystem.h"
+#include "EngineUtils.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("Replication Graph Room Update"), STAT_ALSRepGraphRoomUpdate, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Replication Graph Room Changes"), STAT_ALSRepGraphRoomChanges, STATGROUP_ALSMovement);
+
+namespace ALSReplicationGraphCVars
+{
+	static int32 PortalDepth = 1;
+	FAutoConsoleVariableRef CVarPortalDepth(
+		TEXT("ALS.RepGraph.PortalDepth"),
+		PortalDepth,
+		TEXT("How many portals away from the viewer's room actors are still replicated."),
+		ECVF_Default);
+}
+
+UALSReplicationGraphNode_Rooms::UALSReplicationGraphNode_Rooms()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+bool UALSReplicationGraphNode_Rooms::GetOwnerRoom(const AActor* Actor, int32& OutRoomID)
+{
+	// Weapons and the like are wherever the character holding them is
+	for (const AActor* It = Actor; It; It = It->GetOwner())
+	{
+		if (const AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(It))
+		{
+			OutRoomID = Character->GetCurrentRoomID();
+			return true;
+		}
+
+		if (const AALSRoomFlowReplicator* FlowReplicator = Cast<AALSRoomFlowReplicator>(It))
+		{
+			OutRoomID = FlowReplicator->GetRoomID();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 UALSReplicationGraphNode_Rooms::GetActorRoom(const FTrackedActor& Tracked) const
+{
+	const AActor* Actor = Tracked.ActorInfo.Actor;
+
+	int32 OwnerRoomID = INDEX_NONE;
+	if (GetOwnerRoom(Actor, OwnerRoomID))
+	{
+		return OwnerRoomID;
+	}
+
+	// Physics objects drift between rooms while staying in the level they were spawned in
+	const UALSRoomStreamingSubsystem* Streaming = RoomStreaming.Get();
+	if (Tracked.bMovable && Streaming)
+	{
+		// Most frames the actor is still in the room it was in, one box test instead of a search
+		const FVector Location = Actor->GetActorLocation();
+		if (Streaming->IsInRoom(Tracked.RoomID, Location))
+		{
+			return Tracked.RoomID;
+		}
+
+		const int32 LocationRoomID = Streaming->GetRoomAtLocation(Location);
+		if (LocationRoomID != INDEX_NONE)
+		{
+			return LocationRoomID;
+		}
+	}
+
+	return Tracked.LevelRoomID;
+}
+
+UReplicationGraphNode_ActorList* UALSReplicationGraphNode_Rooms::GetRoomNode(int32 RoomID)
+{
+	UReplicationGraphNode_ActorList*& RoomNode = RoomNodes.FindOrAdd(RoomID);
+	if (!RoomNode)
+	{
+		RoomNode = CreateChildNode<UReplicationGraphNode_ActorList>();
+	}
+
+	return RoomNode;
+}
+
+void UALSReplicationGraphNode_Rooms::AddToRoom(int32 RoomID, const FNewReplicatedActorInfo& ActorInfo)
+{
+	if (RoomID == INDEX_NONE)
+	{
+		UnroomedActors.Add(ActorInfo.Actor);
+	}
+	else
+	{
+		GetRoomNode(RoomID)->NotifyAddNetworkActor(ActorInfo);
+	}
+}
+
+void UALSReplicationGraphNode_Rooms::RemoveFromRoom(int32 RoomID, const FNewReplicatedActorInfo& ActorInfo,
+                                                    bool bWarnIfNotFound)
+{
+	if (RoomID == INDEX_NONE)
+	{
+		UnroomedActors.RemoveSingleSwap(ActorInfo.Actor);
+	}
+	else
+	{
+		GetRoomNode(RoomID)->NotifyRemoveNetworkActor(ActorInfo, bWarnIfNotFound);
+	}
+}
+
+void UALSReplicationGraphNode_Rooms::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* Actor = ActorInfo.Actor;
+
+	if (!RoomStreaming.IsValid())
+	{
+		RoomStreaming = UALSRoomStreamingSubsystem::Get(this);
+	}
+
+	FTrackedActor Tracked(ActorInfo);
+	Tracked.LevelRoomID = RoomStreaming.IsValid() ? RoomStreaming->GetRoomOfLevel(Actor->GetLevel()) : INDEX_NONE;
+	Tracked.bMovable = Actor->IsRootComponentMovable();
+	Tracked.bDynamic = Actor->IsA<AALSBaseCharacter>() || Actor->IsA<AALSRoomFlowReplicator>() ||
+		Actor->GetOwner() != nullptr || Tracked.bMovable;
+	Tracked.RoomID = GetActorRoom(Tracked);
+
+	AddToRoom(Tracked.RoomID, ActorInfo);
+	TrackedActors.Add(Actor, Tracked);
+}
+
+bool UALSReplicationGraphNode_Rooms::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo,
+                                                              bool bWarnIfNotFound)
+{
+	FTrackedActor* Tracked = TrackedActors.Find(ActorInfo.Actor);
+	if (!Tracked)
+	{
+		return false;
+	}
+
+	RemoveFromRoom(Tracked->RoomID, ActorInfo, bWarnIfNotFound);
+	TrackedActors.Remove(ActorInfo.Actor);
+	return true;
+}
+
+void UALSReplicationGraphNode_Rooms::NotifyResetAllNetworkActors()
+{
+	TrackedActors.Reset();
+	UnroomedActors.Reset();
+
+	Super::NotifyResetAllNetworkActors();
+}
+
+void UALSReplicationGraphNode_Rooms::PrepareForReplication()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSRepGraphRoomUpdate);
+
+	if (!RoomStreaming.IsValid())
+	{
+		RoomStreaming = UALSRoomStreamingSubsystem::Get(this);
+	}
+
+	// Move the actors that crossed into another room since the last frame
+	for (TPair<FActorRepListType, FTrackedActor>& Pair : TrackedActors)
+	{
+		FTrackedActor& Tracked = Pair.Value;
+		if (!Tracked.bDynamic)
+		{
+			continue;
+		}
+
+		const int32 RoomID = GetActorRoom(Tracked);
+		if (RoomID != Tracked.RoomID)
+		{
+			RemoveFromRoom(Tracked.RoomID, Tracked.ActorInfo, false);
+			AddToRoom(RoomID, Tracked.ActorInfo);
+			Tracked.RoomID = RoomID;
+			INC_DWORD_STAT(STAT_ALSRepGraphRoomChanges);
+		}
+	}
+}
+
+bool UALSReplicationGraphNode_Rooms::GatherRoomIDs(const FNetViewerArray& Viewers,
+                                                   TArray<int32, TInlineAllocator<16>>& OutRoomIDs) const
+{
+	const UALSRoomStreamingSubsystem* Streaming = RoomStreaming.Get();
+
+	for (const FNetViewer& Viewer : Viewers)
+	{
+		const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer);
+		const AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(Viewer.ViewTarget);
+		if (!Character && PlayerController)
+		{
+			Character = Cast<AALSBaseCharacter>(PlayerController->GetPawn());
+		}
+
+		// Spectators and viewers outside every room see all rooms. Only classes with a cull distance are culled
+		if (!Character || Character->GetCurrentRoomID() == INDEX_NONE)
+		{
+			return false;
+		}
+
+		OutRoomIDs.AddUnique(Character->GetCurrentRoomID());
+		OutRoomIDs.AddUnique(Character->GetPredictedNextRoomID());
+
+		// Rooms seen through portals, walked outwards from the current room
+		TArray<int32, TInlineAllocator<8>> Frontier;
+		TArray<int32, TInlineAllocator<8>> NextFrontier;
+		Frontier.Add(Character->GetCurrentRoomID());
+		for (int32 Depth = 0; Depth < ALSReplicationGraphCVars::PortalDepth && Streaming; ++Depth)
+		{
+			NextFrontier.Reset();
+			for (const int32 RoomID : Frontier)
+			{
+				if (const TArray<int32>* Neighbors = Streaming->GetRoomNeighbors(RoomID))
+				{
+					for (const int32 Neighbor : *Neighbors)
+					{
+						if (!OutRoomIDs.Contains(Neighbor))
+						{
+							OutRoomIDs.Add(Neighbor);
+							NextFrontier.Add(Neighbor);
+						}
+					}
+				}
+			}
+
+			Swap(Frontier, NextFrontier);
+		}
+	}
+
+	return true;
+}
+
+bool UALSReplicationGraphNode_Rooms::IsGatheredFor(const FNetViewerArray& Viewers, const AActor* Actor) const
+{
+	const FTrackedActor* Tracked = TrackedActors.Find(const_cast<AActor*>(Actor));
+	if (!Tracked || Tracked->RoomID == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TArray<int32, TInlineAllocator<16>> GatherRooms;
+	return !GatherRoomIDs(Viewers, GatherRooms) || GatherRooms.Contains(Tracked->RoomID);
+}
+
+void UALSReplicationGraphNode_Rooms::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	TArray<int32, TInlineAllocator<16>> GatherRooms;
+	if (!GatherRoomIDs(Params.Viewers, GatherRooms))
+	{
+		for (const TPair<int32, UReplicationGraphNode_ActorList*>& Pair : RoomNodes)
+		{
+			Pair.Value->GatherActorListsForConnection(Params);
+		}
+
+		return;
+	}
+
+	for (const int32 RoomID : GatherRooms)
+	{
+		if (UReplicationGraphNode_ActorList* const* RoomNode = RoomNodes.Find(RoomID))
+		{
+			(*RoomNode)->GatherActorListsForConnection(Params);
+		}
+	}
+}
+
+void UALSReplicationGraphNode_Unroomed_ForConnection::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	ReplicationActorList.Reset();
+
+	if (RoomsNode)
+	{
+		for (const FActorRepListType& Actor : RoomsNode->GetUnroomedActors())
+		{
+			const FVector Location = Actor->GetActorLocation();
+			for (const FNetViewer& Viewer : Params.Viewers)
+			{
+				if (FVector::DistSquared(Viewer.ViewLocation, Location) <= Actor->NetCullDistanceSquared)
+				{
+					ReplicationActorList.ConditionalAdd(Actor);
+					break;
+				}
+			}
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
+
+void UALSReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	ReplicationActorList.Reset();
+
+	auto AddWithChildren = [this](AActor* Actor)
+	{
+		if (Actor)
+		{
+			ReplicationActorList.ConditionalAdd(Actor);
+			for (AActor* Child : Actor->Children)
+			{
+				ReplicationActorList.ConditionalAdd(Child);
+			}
+		}
+	};
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		AddWithChildren(Viewer.InViewer);
+		AddWithChildren(Viewer.ViewTarget);
+
+		const APlayerController* PlayerController = Cast<APlayerController>(Viewer.InViewer);
+		if (PlayerController && PlayerController->GetPawn() != Viewer.ViewTarget)
+		{
+			AddWithChildren(PlayerController->GetPawn());
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
+
+void UALSReplicationGraph::ResetGameWorldState()
+{
+	Super::ResetGameWorldState();
+
+	if (RoomsNode)
+	{
+		RoomsNode->NotifyResetAllNetworkActors();
+	}
+}
+
+void UALSReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Blueprint compile leftovers never spawn
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		// Rooms decide who gets characters and their flow, not how far away they are
+		const bool bRoomRelevant = Class->IsChildOf(AALSBaseCharacter::StaticClass()) ||
+			Class->IsChildOf(AALSRoomFlowReplicator::StaticClass());
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.SetCullDistanceSquared(bRoomRelevant || ActorCDO->bAlwaysRelevant || ActorCDO->bOnlyRelevantToOwner
+			                                 ? 0.0f
+			                                 : ActorCDO->NetCullDistanceSquared);
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UALSReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	RoomsNode = CreateNewNode<UALSReplicationGraphNode_Rooms>();
+	AddGlobalGraphNode(RoomsNode);
+}
+
+void UALSReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	AddConnectionGraphNode(CreateNewNode<UALSReplicationGraphNode_AlwaysRelevant_ForConnection>(), RepGraphConnection);
+
+	UALSReplicationGraphNode_Unroomed_ForConnection* UnroomedNode =
+		CreateNewNode<UALSReplicationGraphNode_Unroomed_ForConnection>();
+	UnroomedNode->RoomsNode = RoomsNode;
+	AddConnectionGraphNode(UnroomedNode, RepGraphConnection);
+}
+
+bool UALSReplicationGraph::IsRoomRelevant(const AActor* Actor)
+{
+	return Actor->IsA<AALSBaseCharacter>() || Actor->IsA<AALSRoomFlowReplicator>();
+}
+
+void UALSReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+                                                       FGlobalActorReplicationInfo& GlobalInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+	// Characters are bAlwaysRelevant for the default net driver, which has no rooms. Here rooms decide
+	if (IsRoomRelevant(Actor))
+	{
+		RoomsNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+	}
+	else if (!Actor->bOnlyRelevantToOwner)
+	{
+		// Owner only actors go out through the connection's own node
+		RoomsNode->NotifyAddNetworkActor(ActorInfo);
+	}
+}
+
+void UALSReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const AActor* Actor = ActorInfo.Actor;
+	if (IsRoomRelevant(Actor))
+	{
+		RoomsNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (Actor->bAlwaysRelevant)
+	{
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+	else if (!Actor->bOnlyRelevantToOwner)
+	{
+		RoomsNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+// Checks that no connection gets a character from a room it can't see into. Usage: ALS.RepGraph.CheckRooms
+static FAutoConsoleCommandWithWorld GALSRepGraphCheckRoomsCommand(
+	TEXT("ALS.RepGraph.CheckRooms"),
+	TEXT("Logs every character the room graph gathers for a connection whose view target is more than ALS.RepGraph.PortalDepth rooms away from it, and every character that bypasses the rooms."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		const UALSReplicationGraph* Graph = NetDriver ? Cast<UALSReplicationGraph>(NetDriver->GetReplicationDriver()) : nullptr;
+		const UALSReplicationGraphNode_Rooms* RoomsNode = Graph ? Graph->GetRoomsNode() : nullptr;
+		if (!RoomsNode)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ALS.RepGraph.CheckRooms: the net driver doesn't use UALSReplicationGraph"));
+			return;
+		}
+
+		const UALSRoomStreamingSubsystem* Streaming = UALSRoomStreamingSubsystem::Get(World);
+		int32 NumChecked = 0;
+		int32 NumFailed = 0;
+
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			APlayerController* PlayerController = It->Get();
+			UNetConnection* Connection = PlayerController ? PlayerController->GetNetConnection() : nullptr;
+			const AALSBaseCharacter* ViewerCharacter = PlayerController ? Cast<AALSBaseCharacter>(PlayerController->GetPawn()) : nullptr;
+			if (!Connection || !ViewerCharacter || ViewerCharacter->GetCurrentRoomID() == INDEX_NONE)
+			{
+				continue;
+			}
+
+			FNetViewerArray Viewers;
+			Viewers.Emplace(Connection, 0.0f);
+
+			// Rooms the viewer may see, found independently of the node: its own, its predicted one and those within
+			// the portal depth
+			TArray<int32> VisibleRooms = {ViewerCharacter->GetCurrentRoomID(), ViewerCharacter->GetPredictedNextRoomID()};
+			TArray<int32> Frontier = {ViewerCharacter->GetCurrentRoomID()};
+			for (int32 Depth = 0; Depth < ALSReplicationGraphCVars::PortalDepth && Streaming; ++Depth)
+			{
+				TArray<int32> NextFrontier;
+				for (const int32 RoomID : Frontier)
+				{
+					const TArray<int32>* Neighbors = Streaming->GetRoomNeighbors(RoomID);
+					for (const int32 Neighbor : Neighbors ? *Neighbors : TArray<int32>())
+					{
+						if (!VisibleRooms.Contains(Neighbor))
+						{
+							VisibleRooms.Add(Neighbor);
+							NextFrontier.Add(Neighbor);
+						}
+					}
+				}
+
+				Frontier = MoveTemp(NextFrontier);
+			}
+
+			for (TActorIterator<AALSBaseCharacter> CharacterIt(World); CharacterIt; ++CharacterIt)
+			{
+				const AALSBaseCharacter* Character = *CharacterIt;
+				if (Character == ViewerCharacter || Character->GetCurrentRoomID() == INDEX_NONE)
+				{
+					continue;
+				}
+
+				++NumChecked;
+				if (!RoomsNode->IsTracked(Character))
+				{
+					++NumFailed;
+					UE_LOG(LogTemp, Error, TEXT("ALS.RepGraph.CheckRooms: %s is not in the room lists, every connection gets it"),
+					       *Character->GetName());
+				}
+				else if (!VisibleRooms.Contains(Character->GetCurrentRoomID()) && RoomsNode->IsGatheredFor(Viewers, Character))
+				{
+					++NumFailed;
+					UE_LOG(LogTemp, Error, TEXT("ALS.RepGraph.CheckRooms: %s in room %d is gathered for %s in room %d"),
+					       *Character->GetName(), Character->GetCurrentRoomID(), *ViewerCharacter->GetName(),
+					       ViewerCharacter->GetCurrentRoomID());
+				}
+			}
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("ALS.RepGraph.CheckRooms: %d of %d character and connection pairs failed"), NumFailed, NumChecked);
+	}));
+#endif
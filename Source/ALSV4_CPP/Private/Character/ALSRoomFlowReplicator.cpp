@@ -0,0 +1,190 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#include "Character/ALSRoomFlowReplicator.h"
+
+#include "Character/ALSBaseCharacter.h"
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Character/ALSWindFieldSubsystem.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Flow Chunks Dirtied"), STAT_ALSFlowChunksDirtied, STATGROUP_ALSMovement);
+
+// Grid points per replicated chunk, small enough that a local change resends little, large enough to keep per item overhead low
+static constexpr int32 ALS_FLOW_CHUNK_CELLS = 64;
+
+void FALSFlowChunk::PostReplicatedAdd(const FALSFlowChunkArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnChunkReceived();
+	}
+}
+
+void FALSFlowChunk::PostReplicatedChange(const FALSFlowChunkArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnChunkReceived();
+	}
+}
+
+AALSRoomFlowReplicator::AALSRoomFlowReplicator()
+{
+	bReplicates = true;
+	bAlwaysRelevant = false;
+	SetReplicatingMovement(false);
+	// The solver publishes a few times a second at most
+	NetUpdateFrequency = 10.0f;
+}
+
+void AALSRoomFlowReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AALSRoomFlowReplicator, RoomID);
+	DOREPLIFETIME(AALSRoomFlowReplicator, Origin);
+	DOREPLIFETIME(AALSRoomFlowReplicator, CellSize);
+	DOREPLIFETIME(AALSRoomFlowReplicator, Dimensions);
+	DOREPLIFETIME(AALSRoomFlowReplicator, QuantizationRange);
+	DOREPLIFETIME(AALSRoomFlowReplicator, FlowChunks);
+}
+
+void AALSRoomFlowReplicator::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	FlowChunks.Owner = this;
+}
+
+void AALSRoomFlowReplicator::PostNetReceive()
+{
+	Super::PostNetReceive();
+
+	// Chunks and the grid layout may arrive in any order within the bunch, decode once all of it is in
+	if (bFlowDirty)
+	{
+		bFlowDirty = false;
+		PublishReceivedFlow();
+	}
+}
+
+void AALSRoomFlowReplicator::Destroyed()
+{
+	if (GetLocalRole() != ROLE_Authority && RoomID != INDEX_NONE)
+	{
+		if (UALSWindFieldSubsystem* WindField = UALSWindFieldSubsystem::Get(this))
+		{
+			WindField->ClearRoomFlow(RoomID);
+		}
+	}
+
+	Super::Destroyed();
+}
+
+bool AALSRoomFlowReplicator::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget,
+                                              const FVector& SrcLocation) const
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(RealViewer);
+	const AALSBaseCharacter* Character = Cast<AALSBaseCharacter>(PlayerController ? PlayerController->GetPawn() : ViewTarget);
+	if (!Character)
+	{
+		return false;
+	}
+
+	// Only reached without the room graph. The room we are in, and the one we are about to enter so its flow is there
+	// when we arrive
+	return Character->GetCurrentRoomID() == RoomID || Character->GetPredictedNextRoomID() == RoomID;
+}
+
+void AALSRoomFlowReplicator::SetFlow(int32 InRoomID, const FVector& InOrigin, const FVector& InCellSize,
+                                     const FIntVector& InDimensions, const TArray<FVector>& Forces)
+{
+	RoomID = InRoomID;
+	// Round here rather than only on the wire so the server's own copy matches what clients receive
+	Origin = FVector(FMath::RoundToFloat(InOrigin.X), FMath::RoundToFloat(InOrigin.Y), FMath::RoundToFloat(InOrigin.Z));
+	CellSize = FVector(FMath::RoundToFloat(InCellSize.X), FMath::RoundToFloat(InCellSize.Y), FMath::RoundToFloat(InCellSize.Z));
+
+	// A new layout invalidates every chunk the clients have
+	if (Dimensions != InDimensions)
+	{
+		Dimensions = InDimensions;
+		FlowChunks.Chunks.Reset();
+		FlowChunks.MarkArrayDirty();
+	}
+
+	const int32 NumChunks = FMath::DivideAndRoundUp(Forces.Num(), ALS_FLOW_CHUNK_CELLS);
+	if (FlowChunks.Chunks.Num() > NumChunks)
+	{
+		FlowChunks.Chunks.SetNum(NumChunks);
+		FlowChunks.MarkArrayDirty();
+	}
+
+	const float Scale = 127.0f / FMath::Max(QuantizationRange, 1.0f);
+	TArray<int8> Quantized;
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+	{
+		const int32 FirstCell = ChunkIndex * ALS_FLOW_CHUNK_CELLS;
+		const int32 NumCells = FMath::Min(ALS_FLOW_CHUNK_CELLS, Forces.Num() - FirstCell);
+
+		Quantized.Reset(NumCells * 3);
+		for (int32 Cell = FirstCell; Cell < FirstCell + NumCells; ++Cell)
+		{
+			const FVector& Force = Forces[Cell];
+			Quantized.Add(static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Force.X * Scale), -127, 127)));
+			Quantized.Add(static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Force.Y * Scale), -127, 127)));
+			Quantized.Add(static_cast<int8>(FMath::Clamp(FMath::RoundToInt(Force.Z * Scale), -127, 127)));
+		}
+
+		if (!FlowChunks.Chunks.IsValidIndex(ChunkIndex))
+		{
+			FALSFlowChunk& NewChunk = FlowChunks.Chunks.AddDefaulted_GetRef();
+			NewChunk.ChunkIndex = ChunkIndex;
+			NewChunk.Cells = Quantized;
+			FlowChunks.MarkItemDirty(NewChunk);
+			INC_DWORD_STAT(STAT_ALSFlowChunksDirtied);
+		}
+		else if (FlowChunks.Chunks[ChunkIndex].Cells != Quantized)
+		{
+			// Changes below one quantization step never leave the server
+			FALSFlowChunk& Chunk = FlowChunks.Chunks[ChunkIndex];
+			Chunk.Cells = Quantized;
+			FlowChunks.MarkItemDirty(Chunk);
+			INC_DWORD_STAT(STAT_ALSFlowChunksDirtied);
+		}
+	}
+}
+
+void AALSRoomFlowReplicator::DequantizeFlow(TArray<FVector>& OutForces) const
+{
+	const int32 NumCells = FMath::Max(Dimensions.X * Dimensions.Y * Dimensions.Z, 0);
+	const float Scale = FMath::Max(QuantizationRange, 1.0f) / 127.0f;
+
+	OutForces.Reset(NumCells);
+	OutForces.SetNumZeroed(NumCells);
+	for (const FALSFlowChunk& Chunk : FlowChunks.Chunks)
+	{
+		const int32 FirstCell = Chunk.ChunkIndex * ALS_FLOW_CHUNK_CELLS;
+		const int32 NumChunkCells = FMath::Min(Chunk.Cells.Num() / 3, NumCells - FirstCell);
+		for (int32 Cell = 0; Cell < NumChunkCells; ++Cell)
+		{
+			OutForces[FirstCell + Cell] = FVector(Chunk.Cells[Cell * 3], Chunk.Cells[Cell * 3 + 1], Chunk.Cells[Cell * 3 + 2]) * Scale;
+		}
+	}
+}
+
+void AALSRoomFlowReplicator::PublishReceivedFlow()
+{
+	UALSWindFieldSubsystem* WindField = UALSWindFieldSubsystem::Get(this);
+	if (!WindField || Dimensions.X * Dimensions.Y * Dimensions.Z <= 0 || RoomID == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray<FVector> Forces;
+	DequantizeFlow(Forces);
+	WindField->SetRoomFlow(RoomID, Origin, CellSize, Dimensions, MoveTemp(Forces));
+}
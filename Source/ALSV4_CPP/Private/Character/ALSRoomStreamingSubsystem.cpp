@@ -0,0 +1,318 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSRoomStreamingSubsystem.h"
+
+#include "Character/ALSBaseCharacter.h"
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Room Streaming Update"), STAT_ALSRoomStreamingUpdate, STATGROUP_ALSMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Resident Rooms"), STAT_ALSResidentRooms, STATGROUP_ALSMovement);
+
+namespace ALSRoomStreamingCVars
+{
+	static float UpdateInterval = 0.1f;
+	FAutoConsoleVariableRef CVarUpdateInterval(
+		TEXT("ALS.RoomStreaming.UpdateInterval"),
+		UpdateInterval,
+		TEXT("Seconds between checks of which rooms should be resident."),
+		ECVF_Default);
+
+	static int32 LoadDistance = 0;
+	FAutoConsoleVariableRef CVarLoadDistance(
+		TEXT("ALS.RoomStreaming.LoadDistance"),
+		LoadDistance,
+		TEXT("Rooms this many hops in the room graph from a player's current or predicted room are loaded."),
+		ECVF_Default);
+
+	static int32 UnloadDistance = 2;
+	FAutoConsoleVariableRef CVarUnloadDistance(
+		TEXT("ALS.RoomStreaming.UnloadDistance"),
+		UnloadDistance,
+		TEXT("Rooms more hops than this from every player are unloaded. Kept above the load distance so rooms at the edge don't thrash."),
+		ECVF_Default);
+}
+
+void UALSRoomStreamingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(
+		this, &UALSRoomStreamingSubsystem::OnWorldPostActorTick);
+}
+
+void UALSRoomStreamingSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	Rooms.Reset();
+	PendingResidencyChanges.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSRoomStreamingSubsystem* UALSRoomStreamingSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSRoomStreamingSubsystem>() : nullptr;
+}
+
+void UALSRoomStreamingSubsystem::RegisterRoom(int32 RoomID, const FALSStreamedRoom& Room)
+{
+	FALSRoomStreamingState& State = Rooms.FindOrAdd(RoomID);
+	State.Room = Room;
+
+	// Pick up the new flow input right away if the room is already in use
+	if (State.bResident)
+	{
+		if (UALSFlowSolverSubsystem* FlowSolver = UALSFlowSolverSubsystem::Get(this))
+		{
+			FlowSolver->SetRoomInput(RoomID, State.Room.FlowInput);
+		}
+	}
+}
+
+void UALSRoomStreamingSubsystem::UnregisterRoom(int32 RoomID)
+{
+	if (FALSRoomStreamingState* State = Rooms.Find(RoomID))
+	{
+		UnloadRoom(RoomID, *State);
+		if (ULevelStreamingDynamic* StreamingLevel = State->StreamingLevel.Get())
+		{
+			StreamingLevel->SetIsRequestingUnloadAndRemoval(true);
+		}
+
+		Rooms.Remove(RoomID);
+		BroadcastResidencyChanges();
+	}
+}
+
+bool UALSRoomStreamingSubsystem::IsRoomResident(int32 RoomID) const
+{
+	const FALSRoomStreamingState* State = Rooms.Find(RoomID);
+	return State && State->bResident;
+}
+
+const TArray<int32>* UALSRoomStreamingSubsystem::GetRoomNeighbors(int32 RoomID) const
+{
+	const FALSRoomStreamingState* State = Rooms.Find(RoomID);
+	return State ? &State->Room.Neighbors : nullptr;
+}
+
+int32 UALSRoomStreamingSubsystem::GetRoomOfLevel(const ULevel* Level) const
+{
+	if (!Level)
+	{
+		return INDEX_NONE;
+	}
+
+	for (const TPair<int32, FALSRoomStreamingState>& Pair : Rooms)
+	{
+		const ULevelStreamingDynamic* StreamingLevel = Pair.Value.StreamingLevel.Get();
+		if (StreamingLevel && StreamingLevel->GetLoadedLevel() == Level)
+		{
+			return Pair.Key;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+bool UALSRoomStreamingSubsystem::IsInRoom(int32 RoomID, const FVector& Location) const
+{
+	const FALSRoomStreamingState* State = Rooms.Find(RoomID);
+	return State && State->Room.Bounds.IsValid && State->Room.Bounds.IsInsideOrOn(Location);
+}
+
+int32 UALSRoomStreamingSubsystem::GetRoomAtLocation(const FVector& Location) const
+{
+	for (const TPair<int32, FALSRoomStreamingState>& Pair : Rooms)
+	{
+		const FBox& Bounds = Pair.Value.Room.Bounds;
+		if (Bounds.IsValid && Bounds.IsInsideOrOn(Location))
+		{
+			return Pair.Key;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void UALSRoomStreamingSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || Rooms.Num() == 0)
+	{
+		return;
+	}
+
+	TimeSinceLastUpdate += DeltaSeconds;
+	if (TimeSinceLastUpdate < ALSRoomStreamingCVars::UpdateInterval)
+	{
+		return;
+	}
+
+	TimeSinceLastUpdate = 0.0f;
+	UpdateResidency();
+}
+
+void UALSRoomStreamingSubsystem::UpdateResidency()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ALSRoomStreamingUpdate);
+
+	// The server keeps the rooms of every player resident, a client only has its own controllers
+	TArray<int32> Seeds;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const AALSBaseCharacter* Character = PlayerController
+			                                     ? Cast<AALSBaseCharacter>(PlayerController->GetPawn())
+			                                     : nullptr;
+		if (Character)
+		{
+			Seeds.AddUnique(Character->GetCurrentRoomID());
+			Seeds.AddUnique(Character->GetPredictedNextRoomID());
+		}
+	}
+
+	// Nobody to stream around, e.g. between respawns. Keep what is loaded rather than dropping everything
+	if (Seeds.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 LoadDistance = FMath::Max(ALSRoomStreamingCVars::LoadDistance, 0);
+	const int32 UnloadDistance = FMath::Max(ALSRoomStreamingCVars::UnloadDistance, LoadDistance);
+
+	TMap<int32, int32> Distances;
+	GatherRoomDistances(Seeds, UnloadDistance, Distances);
+
+	int32 NumResident = 0;
+	for (TPair<int32, FALSRoomStreamingState>& Pair : Rooms)
+	{
+		const int32* Distance = Distances.Find(Pair.Key);
+		if (!Pair.Value.bResident && Distance && *Distance <= LoadDistance)
+		{
+			LoadRoom(Pair.Key, Pair.Value);
+		}
+		else if (Pair.Value.bResident && !Distance)
+		{
+			UnloadRoom(Pair.Key, Pair.Value);
+		}
+
+		NumResident += Pair.Value.bResident ? 1 : 0;
+	}
+
+	SET_DWORD_STAT(STAT_ALSResidentRooms, NumResident);
+
+	// Listeners may register or unregister rooms, which they can't while the loop above walks them
+	BroadcastResidencyChanges();
+}
+
+void UALSRoomStreamingSubsystem::GatherRoomDistances(const TArray<int32>& Seeds, int32 MaxDistance,
+                                                     TMap<int32, int32>& OutDistances) const
+{
+	// Breadth first, so the first time a room is reached is through the shortest path
+	TArray<int32> Frontier;
+	for (const int32 Seed : Seeds)
+	{
+		if (Rooms.Contains(Seed) && !OutDistances.Contains(Seed))
+		{
+			OutDistances.Add(Seed, 0);
+			Frontier.Add(Seed);
+		}
+	}
+
+	TArray<int32> NextFrontier;
+	for (int32 Distance = 1; Distance <= MaxDistance && Frontier.Num() > 0; ++Distance)
+	{
+		NextFrontier.Reset();
+		for (const int32 RoomID : Frontier)
+		{
+			for (const int32 Neighbor : Rooms.FindChecked(RoomID).Room.Neighbors)
+			{
+				if (Rooms.Contains(Neighbor) && !OutDistances.Contains(Neighbor))
+				{
+					OutDistances.Add(Neighbor, Distance);
+					NextFrontier.Add(Neighbor);
+				}
+			}
+		}
+
+		Swap(Frontier, NextFrontier);
+	}
+}
+
+void UALSRoomStreamingSubsystem::LoadRoom(int32 RoomID, FALSRoomStreamingState& State)
+{
+	State.bResident = true;
+
+	if (!State.Room.Level.IsNull())
+	{
+		ULevelStreamingDynamic* StreamingLevel = State.StreamingLevel.Get();
+		if (!StreamingLevel)
+		{
+			// Named after the room so the server and its clients agree on the package of the instance
+			const FString LevelName = FString::Printf(TEXT("%s_Room%d"), *State.Room.Level.GetAssetName(), RoomID);
+			bool bSuccess = false;
+			StreamingLevel = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(
+				this, State.Room.Level, State.Room.LevelTransform.GetLocation(),
+				State.Room.LevelTransform.Rotator(), bSuccess, LevelName);
+			State.StreamingLevel = StreamingLevel;
+		}
+		else
+		{
+			// Instanced before and streamed out since, bring the same instance back
+			StreamingLevel->SetShouldBeLoaded(true);
+			StreamingLevel->SetShouldBeVisible(true);
+		}
+	}
+
+	// Blended in the background while the level streams, so the flow is published by the time the player arrives
+	if (UALSFlowSolverSubsystem* FlowSolver = UALSFlowSolverSubsystem::Get(this))
+	{
+		FlowSolver->SetRoomInput(RoomID, State.Room.FlowInput);
+	}
+
+	PendingResidencyChanges.Emplace(RoomID, true);
+}
+
+void UALSRoomStreamingSubsystem::UnloadRoom(int32 RoomID, FALSRoomStreamingState& State)
+{
+	if (!State.bResident)
+	{
+		return;
+	}
+
+	State.bResident = false;
+
+	// Gravity sources of the level unregister from the gravity field as it streams out
+	if (ULevelStreamingDynamic* StreamingLevel = State.StreamingLevel.Get())
+	{
+		StreamingLevel->SetShouldBeVisible(false);
+		StreamingLevel->SetShouldBeLoaded(false);
+	}
+
+	if (UALSFlowSolverSubsystem* FlowSolver = UALSFlowSolverSubsystem::Get(this))
+	{
+		FlowSolver->RemoveRoom(RoomID);
+	}
+
+	PendingResidencyChanges.Emplace(RoomID, false);
+}
+
+void UALSRoomStreamingSubsystem::BroadcastResidencyChanges()
+{
+	// Moved out first, a listener changing residency again queues into a fresh list and broadcasts it itself
+	const TArray<TPair<int32, bool>> Changes = MoveTemp(PendingResidencyChanges);
+	PendingResidencyChanges.Reset();
+
+	for (const TPair<int32, bool>& Change : Changes)
+	{
+		OnRoomResidencyChanged.Broadcast(Change.Key, Change.Value);
+	}
+}
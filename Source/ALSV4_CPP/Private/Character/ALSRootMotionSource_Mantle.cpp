@@ -0,0 +1,192 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#include "Character/ALSRootMotionSource_Mantle.h"
+
+#include "Curves/CurveFloat.h"
+#include "Curves/CurveVector.h"
+#include "GameFramework/Character.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Library/ALSMathLibrary.h"
+
+FALSRootMotionSource_Mantle::FALSRootMotionSource_Mantle()
+{
+	InstanceName = TEXT("ALSMantle");
+	AccumulateMode = ERootMotionAccumulateMode::Override;
+
+	// Land on the ledge standing still instead of carrying the last correction velocity into walking
+	FinishVelocityParams.Mode = ERootMotionFinishVelocityMode::SetVelocity;
+	FinishVelocityParams.SetVelocity = FVector::ZeroVector;
+}
+
+void FALSRootMotionSource_Mantle::InitDuration()
+{
+	float MinTime = 0.0f;
+	float MaxTime = 0.0f;
+	if (MantleParams.PositionCorrectionCurve)
+	{
+		MantleParams.PositionCorrectionCurve->GetTimeRange(MinTime, MaxTime);
+	}
+
+	// Same length as the Lerp/Correction curve minus the starting position, at the speed of the animation
+	const float PlayRate = FMath::Max(MantleParams.PlayRate, KINDA_SMALL_NUMBER);
+	Duration = FMath::Max(MaxTime - MantleParams.StartingPosition, 0.0f) / PlayRate;
+}
+
+FTransform FALSRootMotionSource_Mantle::GetMantleTransform(float PlaybackPosition) const
+{
+	// Step 1: Continually update the mantle target from the stored local transform to follow along with moving objects
+	const FTransform MantleTarget = UALSMathLibrary::MantleComponentLocalToWorld(MantleLedgeLS);
+
+	// Step 2: Update the Position and Correction Alphas using the Position/Correction curve set for each Mantle.
+	const FVector CurveVec = MantleParams.PositionCorrectionCurve->GetVectorValue(
+		MantleParams.StartingPosition + PlaybackPosition);
+	const float PositionAlpha = CurveVec.X;
+	const float XYCorrectionAlpha = CurveVec.Y;
+	const float ZCorrectionAlpha = CurveVec.Z;
+	const float BlendIn = BlendInCurve ? BlendInCurve->GetFloatValue(PlaybackPosition) : 1.0f;
+
+	// Step 3: Lerp multiple transforms together for independent control over the horizontal
+	// and vertical blend to the animated start position, as well as the target position.
+
+	// Blend into the animated horizontal and rotation offset using the Y value of the Position/Correction Curve.
+	const FTransform TargetHzTransform(MantleAnimatedStartOffset.GetRotation(),
+	                                   {
+		                                   MantleAnimatedStartOffset.GetLocation().X,
+		                                   MantleAnimatedStartOffset.GetLocation().Y,
+		                                   MantleActualStartOffset.GetLocation().Z
+	                                   },
+	                                   FVector::OneVector);
+	const FTransform& HzLerpResult =
+		UKismetMathLibrary::TLerp(MantleActualStartOffset, TargetHzTransform, XYCorrectionAlpha);
+
+	// Blend into the animated vertical offset using the Z value of the Position/Correction Curve.
+	const FTransform TargetVtTransform(MantleActualStartOffset.GetRotation(),
+	                                   {
+		                                   MantleActualStartOffset.GetLocation().X,
+		                                   MantleActualStartOffset.GetLocation().Y,
+		                                   MantleAnimatedStartOffset.GetLocation().Z
+	                                   },
+	                                   FVector::OneVector);
+	const FTransform& VtLerpResult =
+		UKismetMathLibrary::TLerp(MantleActualStartOffset, TargetVtTransform, ZCorrectionAlpha);
+
+	const FTransform ResultTransform(HzLerpResult.GetRotation(),
+	                                 {
+		                                 HzLerpResult.GetLocation().X, HzLerpResult.GetLocation().Y,
+		                                 VtLerpResult.GetLocation().Z
+	                                 },
+	                                 FVector::OneVector);
+
+	// Blend from the currently blending transforms into the final mantle target using the X
+	// value of the Position/Correction Curve.
+	const FTransform& ResultLerp = UKismetMathLibrary::TLerp(
+		UALSMathLibrary::TransfromAdd(MantleTarget, ResultTransform), MantleTarget,
+		PositionAlpha);
+
+	// Initial Blend In (controlled in the blend in curve) to allow the actor to blend into the Position/Correction
+	// curve at the midoint. This prevents pops when mantling an object lower than the animated mantle.
+	return UKismetMathLibrary::TLerp(UALSMathLibrary::TransfromAdd(MantleTarget, MantleActualStartOffset), ResultLerp,
+	                                 BlendIn);
+}
+
+FRootMotionSource* FALSRootMotionSource_Mantle::Clone() const
+{
+	FALSRootMotionSource_Mantle* CopyPtr = new FALSRootMotionSource_Mantle(*this);
+	return CopyPtr;
+}
+
+bool FALSRootMotionSource_Mantle::Matches(const FRootMotionSource* Other) const
+{
+	if (!FRootMotionSource::Matches(Other))
+	{
+		return false;
+	}
+
+	// We can cast safely here since in FRootMotionSource::Matches() we ensured ScriptStruct equality
+	const FALSRootMotionSource_Mantle* OtherCast = static_cast<const FALSRootMotionSource_Mantle*>(Other);
+
+	return MantleLedgeLS.Component == OtherCast->MantleLedgeLS.Component &&
+		MantleParams.PositionCorrectionCurve == OtherCast->MantleParams.PositionCorrectionCurve &&
+		FMath::IsNearlyEqual(MantleParams.StartingPosition, OtherCast->MantleParams.StartingPosition) &&
+		FMath::IsNearlyEqual(MantleParams.PlayRate, OtherCast->MantleParams.PlayRate) &&
+		MantleLedgeLS.Transform.GetLocation().Equals(OtherCast->MantleLedgeLS.Transform.GetLocation(), 1.0f);
+}
+
+bool FALSRootMotionSource_Mantle::MatchesAndHasSameState(const FRootMotionSource* Other) const
+{
+	// Check that it matches
+	if (!FRootMotionSource::MatchesAndHasSameState(Other))
+	{
+		return false;
+	}
+
+	// The ledge and offsets are fixed once the mantle starts, the only state is the time checked above
+	return true;
+}
+
+void FALSRootMotionSource_Mantle::PrepareRootMotion(float SimulationTime, float MovementTickTime,
+                                                    const ACharacter& Character,
+                                                    const UCharacterMovementComponent& MoveComponent)
+{
+	RootMotionParams.Clear();
+
+	if (MovementTickTime > SMALL_NUMBER && MantleParams.PositionCorrectionCurve && MantleLedgeLS.Component)
+	{
+		const float PlaybackPosition = FMath::Min(GetTime() + SimulationTime, Duration) * MantleParams.PlayRate;
+		const FTransform TargetTransform = GetMantleTransform(PlaybackPosition);
+
+		// Velocity that puts the capsule on the blended target by the end of this tick,
+		// rotation as a delta the movement component applies on top of the actor rotation afterwards.
+		FTransform NewTransform((TargetTransform.GetLocation() - Character.GetActorLocation()) / MovementTickTime);
+		NewTransform.SetRotation(TargetTransform.GetRotation() * Character.GetActorQuat().Inverse());
+		RootMotionParams.Set(NewTransform);
+	}
+
+	SetTime(GetTime() + SimulationTime);
+}
+
+bool FALSRootMotionSource_Mantle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	if (!FRootMotionSource::NetSerialize(Ar, Map, bOutSuccess))
+	{
+		return false;
+	}
+
+	Ar << MantleParams.AnimMontage;
+	Ar << MantleParams.PositionCorrectionCurve;
+	Ar << MantleParams.StartingPosition;
+	Ar << MantleParams.PlayRate;
+	Ar << MantleParams.StartingOffset;
+	Ar << BlendInCurve;
+	Ar << MantleLedgeLS.Component;
+	Ar << MantleLedgeLS.Transform;
+	Ar << MantleActualStartOffset;
+	Ar << MantleAnimatedStartOffset;
+
+	bOutSuccess = true;
+	return true;
+}
+
+UScriptStruct* FALSRootMotionSource_Mantle::GetScriptStruct() const
+{
+	return FALSRootMotionSource_Mantle::StaticStruct();
+}
+
+FString FALSRootMotionSource_Mantle::ToSimpleString() const
+{
+	return FString::Printf(TEXT("[ID:%u]FALSRootMotionSource_Mantle %s %s"), LocalID,
+	                       *InstanceName.GetPlainNameString(), *GetNameSafe(MantleLedgeLS.Component));
+}
+
+void FALSRootMotionSource_Mantle::AddReferencedObjects(class FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(MantleParams.AnimMontage);
+	Collector.AddReferencedObject(MantleParams.PositionCorrectionCurve);
+	Collector.AddReferencedObject(BlendInCurve);
+	Collector.AddReferencedObject(MantleLedgeLS.Component);
+
+	FRootMotionSource::AddReferencedObjects(Collector);
+}
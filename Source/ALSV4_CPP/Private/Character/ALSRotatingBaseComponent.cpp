@@ -0,0 +1,119 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#include "Character/ALSRotatingBaseComponent.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+
+UALSRotatingBaseComponent::UALSRotatingBaseComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	// Before the characters standing on it move
+	PrimaryComponentTick.TickGroup = TG_PrePhysics;
+	SetIsReplicatedByDefault(true);
+}
+
+void UALSRotatingBaseComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UALSRotatingBaseComponent, Spin);
+}
+
+void UALSRotatingBaseComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SpinAxis = SpinAxis.GetSafeNormal(SMALL_NUMBER, FVector::UpVector);
+	BaseRotation = GetOwner()->GetActorQuat();
+
+	if (GetOwner()->HasAuthority())
+	{
+		Spin.Rate = InitialSpinRate;
+		Spin.StartAngle = 0.0f;
+		Spin.StartTime = GetServerTime();
+	}
+
+	SetComponentTickEnabled(bDriveRotation);
+}
+
+void UALSRotatingBaseComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+                                              FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateBasePose();
+}
+
+void UALSRotatingBaseComponent::SetSpinRate(float NewRate)
+{
+	const float Now = GetServerTime();
+	Spin.StartAngle = GetSpinAngle();
+	Spin.StartTime = Now;
+	Spin.Rate = NewRate;
+}
+
+float UALSRotatingBaseComponent::GetSpinAngle() const
+{
+	return FRotator::ClampAxis(Spin.StartAngle + Spin.Rate * (GetServerTime() - Spin.StartTime));
+}
+
+FVector UALSRotatingBaseComponent::GetWorldSpinAxis() const
+{
+	// The spin leaves its own axis and pivot where they are, so the current transform gives the same answer as the base rotation
+	return GetOwner()->GetActorQuat().RotateVector(SpinAxis);
+}
+
+FVector UALSRotatingBaseComponent::GetWorldPivot() const
+{
+	return GetOwner()->GetActorTransform().TransformPosition(PivotOffset);
+}
+
+void UALSRotatingBaseComponent::UpdateBasePose()
+{
+	if (!bDriveRotation || LastPoseFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	LastPoseFrame = GFrameCounter;
+
+	USceneComponent* Root = GetOwner()->GetRootComponent();
+	if (!Root)
+	{
+		return;
+	}
+
+	// Rotate about the pivot, which may be off the root's origin
+	const FVector Pivot = GetWorldPivot();
+	const FQuat NewRotation = BaseRotation * FQuat(SpinAxis, FMath::DegreesToRadians(GetSpinAngle()));
+	const FQuat DeltaRotation = NewRotation * Root->GetComponentQuat().Inverse();
+	const FVector NewLocation = Pivot + DeltaRotation.RotateVector(Root->GetComponentLocation() - Pivot);
+	Root->SetWorldLocationAndRotation(NewLocation, NewRotation);
+}
+
+bool UALSRotatingBaseComponent::GetCentrifugalGravity(const FVector& Location, FVector& OutDirection,
+                                                      float& OutAcceleration) const
+{
+	const FVector Radial = FVector::VectorPlaneProject(Location - GetWorldPivot(), GetWorldSpinAxis());
+	const float Radius = Radial.Size();
+	if (Radius < KINDA_SMALL_NUMBER || Spin.Rate == 0.0f)
+	{
+		return false;
+	}
+
+	// a = w^2 * r, pointing away from the axis
+	OutDirection = Radial / Radius;
+	OutAcceleration = FMath::Square(FMath::DegreesToRadians(Spin.Rate)) * Radius;
+	return true;
+}
+
+float UALSRotatingBaseComponent::GetServerTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
@@ -0,0 +1,201 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/ALSWindFieldSubsystem.h"
+
+#include "Character/ALSBaseCharacter.h"
+#include "Character/ALSCharacterMovementComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Wind Field Update"), STAT_ALSWindFieldUpdate, STATGROUP_ALSMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wind Field Grid Samples"), STAT_ALSWindFieldGridSamples, STATGROUP_ALSMovement);
+
+namespace ALSWindFieldCVars
+{
+	static float SmoothingRate = 2.0f;
+	FAutoConsoleVariableRef CVarSmoothingRate(
+		TEXT("ALS.WindField.SmoothingRate"),
+		SmoothingRate,
+		TEXT("How fast the wind pushing a character or ragdoll eases towards the flow at its location, per second."),
+		ECVF_Default);
+
+	static float MaxForce = 3000.0f;
+	FAutoConsoleVariableRef CVarMaxForce(
+		TEXT("ALS.WindField.MaxForce"),
+		MaxForce,
+		TEXT("Largest wind force per axis a character or ragdoll is pushed with."),
+		ECVF_Default);
+}
+
+void UALSWindFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(
+		this, &UALSWindFieldSubsystem::OnWorldPreActorTick);
+}
+
+void UALSWindFieldSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	RoomGrids.Reset();
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSWindFieldSubsystem* UALSWindFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSWindFieldSubsystem>() : nullptr;
+}
+
+void UALSWindFieldSubsystem::SetRoomFlow(int32 RoomID, const FVector& Origin, const FVector& CellSize,
+                                         const FIntVector& Dimensions, TArray<FVector> Forces)
+{
+	if (Dimensions.X <= 0 || Dimensions.Y <= 0 || Dimensions.Z <= 0 ||
+		Forces.Num() != Dimensions.X * Dimensions.Y * Dimensions.Z)
+	{
+		ClearRoomFlow(RoomID);
+		return;
+	}
+
+	FALSWindGrid& Grid = RoomGrids.FindOrAdd(RoomID);
+	Grid.Origin = Origin;
+	Grid.CellSize = CellSize.ComponentMax(FVector(KINDA_SMALL_NUMBER));
+	Grid.Dimensions = Dimensions;
+	Grid.Forces = MoveTemp(Forces);
+}
+
+void UALSWindFieldSubsystem::ClearRoomFlow(int32 RoomID)
+{
+	RoomGrids.Remove(RoomID);
+}
+
+void UALSWindFieldSubsystem::RegisterCharacter(AALSBaseCharacter* Character)
+{
+	Characters.AddUnique(Character);
+}
+
+bool UALSWindFieldSubsystem::SampleRoomFlow(int32 RoomID, const FVector& Location, FVector& OutForce) const
+{
+	const FALSWindGrid* Grid = RoomGrids.Find(RoomID);
+	if (!Grid)
+	{
+		return false;
+	}
+
+	OutForce = SampleGrid(*Grid, Location);
+	return true;
+}
+
+FVector UALSWindFieldSubsystem::SmoothForce(const FVector& Smoothed, const FVector& Force, float DeltaSeconds)
+{
+	const FVector MaxForce(ALSWindFieldCVars::MaxForce);
+	return FMath::Lerp(Smoothed, Force, FMath::Min(DeltaSeconds * ALSWindFieldCVars::SmoothingRate, 1.0f))
+		.BoundToBox(-MaxForce, MaxForce);
+}
+
+void UALSWindFieldSubsystem::OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || Characters.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ALSWindFieldUpdate);
+
+	Characters.RemoveAll([](const TWeakObjectPtr<AALSBaseCharacter>& Character)
+	{
+		return !Character.IsValid();
+	});
+
+	// Characters mostly share a few rooms, so remember the last grid looked up
+	int32 LastRoomID = INDEX_NONE;
+	const FALSWindGrid* Grid = nullptr;
+
+	for (const TWeakObjectPtr<AALSBaseCharacter>& CharacterPtr : Characters)
+	{
+		AALSBaseCharacter* Character = CharacterPtr.Get();
+		const int32 RoomID = Character->GetCurrentRoomID();
+		if (RoomID != LastRoomID || !Grid)
+		{
+			LastRoomID = RoomID;
+			Grid = RoomGrids.Find(RoomID);
+		}
+
+		FALSWindFieldSample& Sample = Character->WindFieldSample;
+		if (Grid)
+		{
+			Sample.Force = SampleGrid(*Grid, Character->GetActorLocation());
+			INC_DWORD_STAT(STAT_ALSWindFieldGridSamples);
+		}
+		else
+		{
+			Sample.Force = Character->GridSample.Force;
+		}
+
+		Sample.SmoothedForce = SmoothForce(Sample.SmoothedForce, Sample.Force, DeltaSeconds);
+
+		if (Character->GetMovementState() == EALSMovementState::Ragdoll)
+		{
+			// Less push the faster the ragdoll already rides along with the wind
+			const FVector RagdollVelocity = Character->GetLastRagdollVelocity();
+			const FVector WindDirection = Sample.SmoothedForce.GetSafeNormal();
+			const float VelocityDot = WindDirection | RagdollVelocity.GetSafeNormal();
+			Sample.RagdollForce = Sample.SmoothedForce -
+				RagdollVelocity.Size() * WindDirection * FMath::Clamp(VelocityDot, 0.f, 1.f);
+		}
+		else
+		{
+			Sample.RagdollForce = FVector::ZeroVector;
+		}
+	}
+}
+
+FVector UALSWindFieldSubsystem::SampleGrid(const FALSWindGrid& Grid, const FVector& Location)
+{
+	const FVector GridLocation = (Location - Grid.Origin) / Grid.CellSize;
+	const FVector MaxIndex(Grid.Dimensions.X - 1, Grid.Dimensions.Y - 1, Grid.Dimensions.Z - 1);
+	const FVector Clamped = GridLocation.BoundToBox(FVector::ZeroVector, MaxIndex);
+
+	const int32 X0 = FMath::FloorToInt(Clamped.X);
+	const int32 Y0 = FMath::FloorToInt(Clamped.Y);
+	const int32 Z0 = FMath::FloorToInt(Clamped.Z);
+	const int32 X1 = FMath::Min(X0 + 1, Grid.Dimensions.X - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Grid.Dimensions.Y - 1);
+	const int32 Z1 = FMath::Min(Z0 + 1, Grid.Dimensions.Z - 1);
+
+	const int32 StrideY = Grid.Dimensions.X;
+	const int32 StrideZ = Grid.Dimensions.X * Grid.Dimensions.Y;
+	const FVector* Forces = Grid.Forces.GetData();
+
+	auto Load = [&](int32 X, int32 Y, int32 Z)
+	{
+		return VectorLoadFloat3(&Forces[X + Y * StrideY + Z * StrideZ]);
+	};
+
+	// Lerp along X, then Y, then Z, four lanes at a time
+	const VectorRegister FracX = VectorSetFloat1(Clamped.X - X0);
+	const VectorRegister FracY = VectorSetFloat1(Clamped.Y - Y0);
+	const VectorRegister FracZ = VectorSetFloat1(Clamped.Z - Z0);
+
+	auto Lerp = [](const VectorRegister& A, const VectorRegister& B, const VectorRegister& Alpha)
+	{
+		return VectorMultiplyAdd(VectorSubtract(B, A), Alpha, A);
+	};
+
+	const VectorRegister C00 = Lerp(Load(X0, Y0, Z0), Load(X1, Y0, Z0), FracX);
+	const VectorRegister C10 = Lerp(Load(X0, Y1, Z0), Load(X1, Y1, Z0), FracX);
+	const VectorRegister C01 = Lerp(Load(X0, Y0, Z1), Load(X1, Y0, Z1), FracX);
+	const VectorRegister C11 = Lerp(Load(X0, Y1, Z1), Load(X1, Y1, Z1), FracX);
+	const VectorRegister C0 = Lerp(C00, C10, FracY);
+	const VectorRegister C1 = Lerp(C01, C11, FracY);
+
+	FVector Result;
+	VectorStoreFloat3(Lerp(C0, C1, FracZ), &Result);
+	return Result;
+}
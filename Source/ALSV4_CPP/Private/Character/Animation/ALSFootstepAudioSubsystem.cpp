@@ -0,0 +1,190 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#include "Character/Animation/ALSFootstepAudioSubsystem.h"
+
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Played"), STAT_ALSFootstepsPlayed, STATGROUP_ALSFootsteps);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Out Of Range"), STAT_ALSFootstepsOutOfRange, STATGROUP_ALSFootsteps);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Over Budget"), STAT_ALSFootstepsOverBudget, STATGROUP_ALSFootsteps);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Components"), STAT_ALSFootstepsPooled, STATGROUP_ALSFootsteps);
+
+namespace ALSFootstepCVars
+{
+	static int32 MaxConcurrent = 16;
+	FAutoConsoleVariableRef CVarMaxConcurrent(
+		TEXT("ALS.Footsteps.MaxConcurrent"),
+		MaxConcurrent,
+		TEXT("Footstep sounds that can play at once in a world."),
+		ECVF_Default);
+
+	static float MaxDistance = 3000.0f;
+	FAutoConsoleVariableRef CVarMaxDistance(
+		TEXT("ALS.Footsteps.MaxDistance"),
+		MaxDistance,
+		TEXT("Footsteps further than this from every listener are skipped, even if their attenuation reaches further."),
+		ECVF_Default);
+}
+
+bool UALSFootstepAudioSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Nothing is heard on a dedicated server
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UALSFootstepAudioSubsystem::Deinitialize()
+{
+	for (UAudioComponent* Component : Components)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+
+	Components.Reset();
+	Priorities.Reset();
+
+	Super::Deinitialize();
+}
+
+UALSFootstepAudioSubsystem* UALSFootstepAudioSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UALSFootstepAudioSubsystem>() : nullptr;
+}
+
+UAudioComponent* UALSFootstepAudioSubsystem::PlayFootstep(USoundBase* Sound, USceneComponent* AttachTo,
+                                                          FName AttachPointName, float VolumeMultiplier,
+                                                          float PitchMultiplier, int32 FootstepType)
+{
+	if (!Sound || !AttachTo || VolumeMultiplier <= 0.0f)
+	{
+		return nullptr;
+	}
+
+	const float AudibleRange = FMath::Min(Sound->GetMaxDistance(), ALSFootstepCVars::MaxDistance);
+	const FVector Location = AttachTo->GetSocketLocation(AttachPointName);
+	const float Priority = GetFootstepPriority(AttachTo, Location, AudibleRange, VolumeMultiplier);
+	if (Priority < 0.0f)
+	{
+		INC_DWORD_STAT(STAT_ALSFootstepsOutOfRange);
+		return nullptr;
+	}
+
+	const int32 Index = AcquireComponent(Priority);
+	if (Index == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_ALSFootstepsOverBudget);
+		return nullptr;
+	}
+
+	UAudioComponent* Component = Components[Index];
+	Priorities[Index] = Priority;
+
+	if (Component->GetAttachParent() != AttachTo || Component->GetAttachSocketName() != AttachPointName)
+	{
+		Component->AttachToComponent(AttachTo, FAttachmentTransformRules::SnapToTargetNotIncludingScale,
+		                             AttachPointName);
+	}
+
+	Component->SetSound(Sound);
+	Component->SetVolumeMultiplier(VolumeMultiplier);
+	Component->SetPitchMultiplier(PitchMultiplier);
+	Component->SetIntParameter(FName(TEXT("FootstepType")), FootstepType);
+	Component->Play();
+
+	INC_DWORD_STAT(STAT_ALSFootstepsPlayed);
+	return Component;
+}
+
+float UALSFootstepAudioSubsystem::GetFootstepPriority(const USceneComponent* AttachTo, const FVector& Location,
+                                                      float AudibleRange, float VolumeMultiplier) const
+{
+	float BestDistance = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (!PC || !PC->IsLocalController())
+		{
+			continue;
+		}
+
+		// The player's own steps always win over everyone else's
+		if (PC->GetPawn() && PC->GetPawn() == AttachTo->GetOwner())
+		{
+			return 1.0f + VolumeMultiplier;
+		}
+
+		FVector ListenerLocation;
+		FVector FrontDir;
+		FVector RightDir;
+		PC->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+		BestDistance = FMath::Min(BestDistance, FVector::Dist(ListenerLocation, Location));
+	}
+
+	if (BestDistance > AudibleRange || AudibleRange <= 0.0f)
+	{
+		return -1.0f;
+	}
+
+	// Closer and louder steps first
+	return VolumeMultiplier * (1.0f - BestDistance / AudibleRange);
+}
+
+int32 UALSFootstepAudioSubsystem::AcquireComponent(float Priority)
+{
+	int32 LowestIndex = INDEX_NONE;
+	for (int32 Index = 0; Index < Components.Num(); ++Index)
+	{
+		UAudioComponent* Component = Components[Index];
+		if (!Component || Component->IsPendingKill())
+		{
+			// Went away with the level, take the slot back
+			Components.RemoveAtSwap(Index);
+			Priorities.RemoveAtSwap(Index);
+			DEC_DWORD_STAT(STAT_ALSFootstepsPooled);
+			--Index;
+			continue;
+		}
+
+		if (!Component->IsPlaying())
+		{
+			return Index;
+		}
+
+		if (LowestIndex == INDEX_NONE || Priorities[Index] < Priorities[LowestIndex])
+		{
+			LowestIndex = Index;
+		}
+	}
+
+	if (Components.Num() < ALSFootstepCVars::MaxConcurrent)
+	{
+		UAudioComponent* Component = NewObject<UAudioComponent>(GetWorld());
+		Component->bAutoActivate = false;
+		Component->bAutoDestroy = false;
+		Component->bAllowSpatialization = true;
+		Component->RegisterComponentWithWorld(GetWorld());
+		Priorities.Add(0.0f);
+		INC_DWORD_STAT(STAT_ALSFootstepsPooled);
+		return Components.Add(Component);
+	}
+
+	// At the cap, cut the least important footstep if this one matters more
+	if (LowestIndex != INDEX_NONE && Priorities[LowestIndex] < Priority)
+	{
+		Components[LowestIndex]->Stop();
+		return LowestIndex;
+	}
+
+	return INDEX_NONE;
+}
@@ -9,6 +9,7 @@
 #include "Character/Animation/Notify/ALSAnimNotifyFootstep.h"
 
 
+#include "Character/Animation/ALSFootstepAudioSubsystem.h"
 #include "Components/AudioComponent.h"
 #include "Kismet/GameplayStatics.h"
 
@@ -22,8 +23,26 @@ void UALSAnimNotifyFootstep::Notify(USkeletalMeshComponent* MeshComp, UAnimSeque
 	const float MaskCurveValue = MeshComp->GetAnimInstance()->GetCurveValue(FName(TEXT("Mask_FootstepSound")));
 	const float FinalVolMult = bOverrideMaskCurve ? VolumeMultiplier : VolumeMultiplier * (1.0f - MaskCurveValue);
 
-	if (Sound)
+	if (!Sound)
 	{
+		return;
+	}
+
+	UWorld* World = MeshComp->GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		// Game worlds play from the shared pool, which also skips footsteps nobody can hear.
+		// No subsystem means a dedicated server, where there is nothing to play.
+		UALSFootstepAudioSubsystem* FootstepAudio = World->GetSubsystem<UALSFootstepAudioSubsystem>();
+		if (FootstepAudio)
+		{
+			FootstepAudio->PlayFootstep(Sound, MeshComp, AttachPointName, FinalVolMult, PitchMultiplier,
+			                            static_cast<int32>(FootstepType));
+		}
+	}
+	else
+	{
+		// Animation editor previews have no listener to cull against
 		UAudioComponent* SpawnedAudio = UGameplayStatics::SpawnSoundAttached(Sound, MeshComp, AttachPointName,
 		                                                                     FVector::ZeroVector, FRotator::ZeroRotator,
 		                                                                     EAttachLocation::Type::KeepRelativeOffset,
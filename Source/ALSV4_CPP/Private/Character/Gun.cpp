@@ -4,12 +4,89 @@
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Character/ImpactEffect.h"
+#include "Character/ImpactEffectSubsystem.h"
+#include "Character/WeaponFXSubsystem.h"
 #include "Character/ALSBaseCharacter.h"
+#include "Character/ALSHitboxHistoryComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
 #include "DrawDebugHelpers.h"
 
 AGun::AGun()
 {
 	CurrentFiringSpread = 0.0f;
+	PendingShotCount = 0;
+}
+
+bool FInstantHitReport::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	// most batches hold a handful of traces, so the index usually fits a single byte
+	uint32 PackedShotIndex = ShotIndex;
+	Ar.SerializeIntPacked(PackedShotIndex);
+	ShotIndex = (uint16)FMath::Min<uint32>(PackedShotIndex, MAX_uint16);
+
+	uint8 bHit = bBlockingHit;
+	uint8 bHasActor = HitActor != nullptr;
+	uint8 bHasBone = !BoneName.IsNone();
+	uint8 bHasComponent = HitComponent != nullptr;
+	uint8 bHasPhysMaterial = PhysMaterial != nullptr;
+	Ar.SerializeBits(&bHit, 1);
+	Ar.SerializeBits(&bHasActor, 1);
+	Ar.SerializeBits(&bHasBone, 1);
+	Ar.SerializeBits(&bHasComponent, 1);
+	Ar.SerializeBits(&bHasPhysMaterial, 1);
+
+	if (Ar.IsLoading())
+	{
+		bBlockingHit = bHit;
+		HitActor = nullptr;
+		BoneName = NAME_None;
+		HitComponent = nullptr;
+		PhysMaterial = nullptr;
+	}
+
+	if (bHasActor)
+	{
+		UObject* ActorObject = HitActor;
+		bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), ActorObject);
+		HitActor = Cast<AActor>(ActorObject);
+	}
+
+	if (bHasBone)
+	{
+		bOutSuccess &= Map->SerializeName(Ar, BoneName);
+	}
+
+	// components and materials resolve when they are stably named, e.g. a character's mesh, and are null otherwise
+	if (bHasComponent)
+	{
+		UObject* ComponentObject = HitComponent;
+		bOutSuccess &= Map->SerializeObject(Ar, UPrimitiveComponent::StaticClass(), ComponentObject);
+		HitComponent = Cast<UPrimitiveComponent>(ComponentObject);
+	}
+
+	if (bHasPhysMaterial)
+	{
+		UObject* MaterialObject = PhysMaterial;
+		bOutSuccess &= Map->SerializeObject(Ar, UPhysicalMaterial::StaticClass(), MaterialObject);
+		PhysMaterial = Cast<UPhysicalMaterial>(MaterialObject);
+	}
+
+	bool bLocalSuccess = true;
+	ShootDir.NetSerialize(Ar, Map, bLocalSuccess);
+
+	// misses only need the direction to draw their trail
+	if (bHit)
+	{
+		ImpactPoint.NetSerialize(Ar, Map, bLocalSuccess);
+		ImpactNormal.NetSerialize(Ar, Map, bLocalSuccess);
+	}
+
+	bOutSuccess &= bLocalSuccess;
+	return true;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -19,32 +96,120 @@ void AGun::FireWeapon()
 {
 	//UE_LOG(LogTemp, Log, TEXT("AGun CurrentAmmo: %d"), CurrentAmmo);
 	UE_LOG(LogTemp, Log, TEXT("AGun CurrentAmmo: %d"), CurrentAmmoInClip);
-	const int32 RandomSeed = FMath::Rand();
-	FRandomStream WeaponRandomStream(RandomSeed);
 	const float CurrentSpread = GetCurrentSpread();
 	const float ConeHalfAngle = FMath::DegreesToRadians(CurrentSpread * 0.5f);
 	const FVector StartTrace = MyPawn->GetFirstPersonCamera()->GetComponentLocation();
-	const FVector ShootDir = MyPawn->GetFirstPersonCamera()->GetForwardVector();
-	const FVector EndTrace = StartTrace + (ShootDir * InstantConfig.WeaponRange);
+	const FVector AimDir = MyPawn->GetFirstPersonCamera()->GetForwardVector();
 	//const FVector AimDir = GetAdjustedAim();
 	//const FVector StartTrace = GetCameraDamageStartLocation(AimDir);
-	//const FVector ShootDir = WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle);
-	//const FVector EndTrace = StartTrace + ShootDir * InstantConfig.WeaponRange;
 
-	const FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
-	
-	DrawDebugLine(this->GetWorld(), StartTrace, Impact.Location, FColor::Green, false, 2.f, 0, 10.f);
-	ProcessInstantHit(Impact, StartTrace, ShootDir, RandomSeed, CurrentSpread);
+	// every trace of this frame derives its seed from the batch seed and its index in the batch
+	if (PendingShotCount == 0)
+	{
+		PendingHitBatch.RandomSeed = FMath::Rand();
+	}
+
+	for (int32 PelletIndex = 0; PelletIndex < InstantConfig.PelletsPerShot; PelletIndex++)
+	{
+		const int32 RandomSeed = PendingHitBatch.RandomSeed + PendingShotCount++;
+		FRandomStream WeaponRandomStream(RandomSeed);
+
+		// single bullets go straight down the camera, pellets spread over the cone
+		const FVector ShootDir = InstantConfig.PelletsPerShot > 1 ? WeaponRandomStream.VRandCone(AimDir, ConeHalfAngle, ConeHalfAngle) : AimDir;
+		const FVector EndTrace = StartTrace + (ShootDir * InstantConfig.WeaponRange);
+
+		const FHitResult Impact = WeaponTrace(StartTrace, EndTrace);
+
+		DrawDebugLine(this->GetWorld(), StartTrace, Impact.Location, FColor::Green, false, 2.f, 0, 10.f);
+		ProcessInstantHit(Impact, StartTrace, ShootDir, RandomSeed, CurrentSpread);
+	}
 
 	CurrentFiringSpread = FMath::Min(InstantConfig.FiringSpreadMax, CurrentFiringSpread + InstantConfig.FiringSpreadIncrement);
 }
 
-bool AGun::ServerNotifyHit_Validate(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread, const FVector& Origin)
+void AGun::QueueHitReport(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
+{
+	if (PendingHitBatch.Shots.Num() == 0)
+	{
+		PendingHitBatch.Origin = Origin;
+		PendingHitBatch.ReticleSpread = ReticleSpread;
+		PendingHitBatch.ClientFireTime = GetClientFireTime();
+	}
+
+	FInstantHitReport& Report = PendingHitBatch.Shots.AddDefaulted_GetRef();
+	Report.ShotIndex = (uint16)(RandomSeed - PendingHitBatch.RandomSeed);
+	Report.bBlockingHit = Impact.bBlockingHit;
+	Report.HitActor = Impact.GetActor();
+	Report.ImpactPoint = Impact.ImpactPoint;
+	Report.ImpactNormal = Impact.ImpactNormal;
+	Report.ShootDir = ShootDir;
+	Report.BoneName = Impact.BoneName;
+	Report.HitComponent = Impact.GetComponent();
+	Report.PhysMaterial = Impact.PhysMaterial.Get();
+}
+
+void AGun::FlushFiredShots()
 {
+	if (PendingHitBatch.Shots.Num() > 0)
+	{
+		ServerNotifyHitBatch(PendingHitBatch);
+	}
+
+	PendingHitBatch.Shots.Reset();
+	PendingShotCount = 0;
+}
+
+bool AGun::ServerNotifyHitBatch_Validate(const FInstantHitBatch& Batch)
+{
+	// a frame can't hold more traces than the weapon is able to fire in one
+	const int32 MaxTraces = WeaponConfig.MaxShotsPerFrame * InstantConfig.PelletsPerShot;
+	if (Batch.Shots.Num() > MaxTraces)
+	{
+		return false;
+	}
+
+	for (const FInstantHitReport& Report : Batch.Shots)
+	{
+		if (Report.ShotIndex >= MaxTraces)
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
 
-void AGun::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread, const FVector& Origin)
+void AGun::ServerNotifyHitBatch_Implementation(const FInstantHitBatch& Batch)
+{
+	for (const FInstantHitReport& Report : Batch.Shots)
+	{
+		const int32 RandomSeed = Batch.RandomSeed + Report.ShotIndex;
+
+		if (!Report.bBlockingHit)
+		{
+			HandleClientMiss(Report.ShootDir, RandomSeed, Batch.ReticleSpread);
+			continue;
+		}
+
+		// rebuild the parts of the client's hit result the verification and damage rely on
+		FHitResult Impact;
+		Impact.bBlockingHit = true;
+		Impact.Actor = Report.HitActor;
+		Impact.TraceStart = Batch.Origin;
+		Impact.Location = Report.ImpactPoint;
+		Impact.ImpactPoint = Report.ImpactPoint;
+		Impact.Normal = Report.ImpactNormal;
+		Impact.ImpactNormal = Report.ImpactNormal;
+		Impact.BoneName = Report.BoneName;
+		// a component of anything but the hit actor is a lie
+		Impact.Component = Report.HitComponent && Report.HitComponent->GetOwner() == Report.HitActor ? Report.HitComponent : nullptr;
+		Impact.PhysMaterial = Report.PhysMaterial;
+
+		HandleClientHit(Impact, Report.ShootDir, RandomSeed, Batch.ReticleSpread, Batch.Origin, Batch.ClientFireTime);
+	}
+}
+
+void AGun::HandleClientHit(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread, const FVector& Origin, float ClientFireTime)
 {
 	const float WeaponAngleDot = FMath::Abs(FMath::Sin(ReticleSpread * PI / 180.f));
 
@@ -75,34 +240,13 @@ void AGun::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQ
 				{
 					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 				}
+				else if (ValidateClientHit(Impact, Origin, ClientFireTime))
+				{
+					ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
+				}
 				else
 				{
-					// Get the component bounding box
-					const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
-
-					// calculate the box extent, and increase by a leeway
-					FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
-					BoxExtent *= InstantConfig.ClientSideHitLeeway;
-
-					// avoid precision errors with really thin objects
-					BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
-					BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
-					BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
-
-					// Get the box center
-					const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
-
-					// if we are within client tolerance
-					if (FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
-						FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
-						FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y)
-					{
-						ProcessInstantHit_Confirmed(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
-					}
-					else
-					{
-						UE_LOG(LogClass, Log, TEXT("%s Rejected client side hit of %s (outside bounding box tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
-					}
+					UE_LOG(LogClass, Log, TEXT("%s Rejected client side hit of %s (outside hitbox tolerance)"), *GetNameSafe(this), *GetNameSafe(Impact.GetActor()));
 				}
 			}
 		}
@@ -117,12 +261,48 @@ void AGun::ServerNotifyHit_Implementation(const FHitResult& Impact, FVector_NetQ
 	}
 }
 
-bool AGun::ServerNotifyMiss_Validate(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+bool AGun::ValidateClientHit(const FHitResult& Impact, const FVector& Origin, float ClientFireTime) const
 {
-	return true;
+	// characters keep a history of simplified hitboxes, test the shot against them as the client saw them
+	const UALSHitboxHistoryComponent* HitboxHistory = Impact.GetActor()->FindComponentByClass<UALSHitboxHistoryComponent>();
+	if (HitboxHistory && HitboxHistory->GetOldestRecordedTime() >= 0.0f)
+	{
+		const FVector ShotDir = (Impact.ImpactPoint - Origin).GetSafeNormal();
+		const FVector ShotEnd = Impact.ImpactPoint + ShotDir * HitboxHistory->HitLeeway * 2.0f;
+		// ExactPing is the round trip in milliseconds
+		const APlayerState* ShooterState = MyPawn ? MyPawn->GetPlayerState() : nullptr;
+		const float ShooterLatency = ShooterState ? ShooterState->ExactPing * 0.001f : 0.0f;
+		return HitboxHistory->ValidateShot(Origin, ShotEnd, ClientFireTime, ShooterLatency);
+	}
+
+	// Get the component bounding box
+	const FBox HitBox = Impact.GetActor()->GetComponentsBoundingBox();
+
+	// calculate the box extent, and increase by a leeway
+	FVector BoxExtent = 0.5 * (HitBox.Max - HitBox.Min);
+	BoxExtent *= InstantConfig.ClientSideHitLeeway;
+
+	// avoid precision errors with really thin objects
+	BoxExtent.X = FMath::Max(20.0f, BoxExtent.X);
+	BoxExtent.Y = FMath::Max(20.0f, BoxExtent.Y);
+	BoxExtent.Z = FMath::Max(20.0f, BoxExtent.Z);
+
+	// Get the box center
+	const FVector BoxCenter = (HitBox.Min + HitBox.Max) * 0.5;
+
+	// if we are within client tolerance
+	return FMath::Abs(Impact.Location.Z - BoxCenter.Z) < BoxExtent.Z &&
+		FMath::Abs(Impact.Location.X - BoxCenter.X) < BoxExtent.X &&
+		FMath::Abs(Impact.Location.Y - BoxCenter.Y) < BoxExtent.Y;
+}
+
+float AGun::GetClientFireTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
 }
 
-void AGun::ServerNotifyMiss_Implementation(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread)
+void AGun::HandleClientMiss(const FVector& ShootDir, int32 RandomSeed, float ReticleSpread)
 {
 	const FVector Origin = GetMuzzleLocation();
 
@@ -143,24 +323,11 @@ void AGun::ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, co
 {
 	if (MyPawn && MyPawn->IsLocallyControlled() && GetNetMode() == NM_Client)
 	{
-		// if we're a client and we've hit something that is being controlled by the server
-		if (Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority)
+		// if we're a client and we've hit something that is being controlled by the server,
+		// or the world, queue it for the server; the whole frame goes out in FlushFiredShots
+		if ((Impact.GetActor() && Impact.GetActor()->GetRemoteRole() == ROLE_Authority) || Impact.GetActor() == NULL)
 		{
-			// notify the server of the hit
-			ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread, Origin);
-		}
-		else if (Impact.GetActor() == NULL)
-		{
-			if (Impact.bBlockingHit)
-			{
-				// notify the server of the hit
-				ServerNotifyHit(Impact, ShootDir, RandomSeed, ReticleSpread, Origin);
-			}
-			else
-			{
-				// notify server of the miss
-				ServerNotifyMiss(ShootDir, RandomSeed, ReticleSpread);
-			}
+			QueueHitReport(Impact, Origin, ShootDir, RandomSeed, ReticleSpread);
 		}
 	}
 
@@ -293,12 +460,13 @@ void AGun::SpawnImpactEffects(const FHitResult& Impact)
 			UseImpact = Hit;
 		}
 
-		FTransform const SpawnTransform(Impact.ImpactNormal.Rotation(), Impact.ImpactPoint);
-		AImpactEffect* EffectActor = GetWorld()->SpawnActorDeferred<AImpactEffect>(ImpactTemplate, SpawnTransform);
-		if (EffectActor)
+		UImpactEffectSubsystem* ImpactEffects = UImpactEffectSubsystem::Get(this);
+		if (ImpactEffects)
 		{
-			//EffectActor->SurfaceHit = UseImpact;
-			//UGameplayStatics::FinishSpawningActor(EffectActor, SpawnTransform);
+			FImpactEffectRequest Request(ImpactTemplate, UseImpact);
+			Request.Location = Impact.ImpactPoint;
+			Request.Normal = Impact.ImpactNormal;
+			ImpactEffects->SpawnImpact(Request);
 		}
 	}
 }
@@ -309,10 +477,10 @@ void AGun::SpawnTrailEffect(const FVector& EndPoint)
 	{
 		const FVector Origin = GetMuzzleLocation();
 
-		UParticleSystemComponent* TrailPSC = UGameplayStatics::SpawnEmitterAtLocation(this, TrailFX, Origin);
-		if (TrailPSC)
+		UWeaponFXSubsystem* WeaponFX = UWeaponFXSubsystem::Get(this);
+		if (WeaponFX)
 		{
-			TrailPSC->SetVectorParameter(TrailTargetParam, EndPoint);
+			WeaponFX->SpawnTrail(this, TrailFX, Origin, EndPoint, TrailTargetParam);
 		}
 	}
 }
@@ -1,5 +1,6 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 #include "Character/ImpactEffect.h"
+#include "Character/ImpactEffectSubsystem.h"
 #include "ParticleDefinitions.h"
 #include "SoundDefinitions.h"
 #include "Kismet/GameplayStatics.h"
@@ -21,69 +22,51 @@ void AImpactEffect::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
 
-	UPhysicalMaterial* HitPhysMat = SurfaceHit.PhysMaterial.Get();
-	EPhysicalSurface HitSurfaceType = UPhysicalMaterial::DetermineSurfaceType(HitPhysMat);
-
-	// show particles
-	UParticleSystem* ImpactFX = GetImpactFX(HitSurfaceType);
-	if (ImpactFX)
-	{
-		UGameplayStatics::SpawnEmitterAtLocation(this, ImpactFX, GetActorLocation(), GetActorRotation());
-	}
-
-	// play sound
-	USoundCue* ImpactSound = GetImpactSound(HitSurfaceType);
-	if (ImpactSound)
+	// effects come from the pools, the actor only carries the hit for placed or blueprint spawned impacts
+	UImpactEffectSubsystem* ImpactEffects = UImpactEffectSubsystem::Get(this);
+	if (ImpactEffects)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
-	}
-
-	if (DefaultDecal.DecalMaterial)
-	{
-		FRotator RandomDecalRotation = SurfaceHit.ImpactNormal.Rotation();
-		RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
-
-		UGameplayStatics::SpawnDecalAttached(DefaultDecal.DecalMaterial, FVector(1.0f, DefaultDecal.DecalSize, DefaultDecal.DecalSize),
-			SurfaceHit.Component.Get(), SurfaceHit.BoneName,
-			SurfaceHit.ImpactPoint, RandomDecalRotation, EAttachLocation::KeepWorldPosition,
-			DefaultDecal.LifeSpan);
+		FImpactEffectRequest Request(GetClass(), SurfaceHit);
+		Request.Location = GetActorLocation();
+		Request.Normal = GetActorRotation().Vector();
+		ImpactEffects->SpawnImpact(Request);
 	}
 }
 
-UParticleSystem* AImpactEffect::GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const
+UParticleSystem* AImpactEffect::GetImpactFX(EPhysMaterialType::Type MaterialType) const
 {
 	UParticleSystem* ImpactFX = NULL;
 
-	switch (SurfaceType)
+	switch (MaterialType)
 	{
-	case SURFACE_Concrete:	ImpactFX = ConcreteFX; break;
-	case SURFACE_Dirt:		ImpactFX = DirtFX; break;
-	case SURFACE_Water:		ImpactFX = WaterFX; break;
-	case SURFACE_Metal:		ImpactFX = MetalFX; break;
-	case SURFACE_Wood:		ImpactFX = WoodFX; break;
-	case SURFACE_Grass:		ImpactFX = GrassFX; break;
-	case SURFACE_Glass:		ImpactFX = GlassFX; break;
-	case SURFACE_Flesh:		ImpactFX = FleshFX; break;
+	case EPhysMaterialType::Concrete:	ImpactFX = ConcreteFX; break;
+	case EPhysMaterialType::Dirt:	ImpactFX = DirtFX; break;
+	case EPhysMaterialType::Water:	ImpactFX = WaterFX; break;
+	case EPhysMaterialType::Metal:	ImpactFX = MetalFX; break;
+	case EPhysMaterialType::Wood:	ImpactFX = WoodFX; break;
+	case EPhysMaterialType::Grass:	ImpactFX = GrassFX; break;
+	case EPhysMaterialType::Glass:	ImpactFX = GlassFX; break;
+	case EPhysMaterialType::Flesh:	ImpactFX = FleshFX; break;
 	default:						ImpactFX = DefaultFX; break;
 	}
 
 	return ImpactFX;
 }
 
-USoundCue* AImpactEffect::GetImpactSound(TEnumAsByte<EPhysicalSurface> SurfaceType) const
+USoundCue* AImpactEffect::GetImpactSound(EPhysMaterialType::Type MaterialType) const
 {
 	USoundCue* ImpactSound = NULL;
 
-	switch (SurfaceType)
+	switch (MaterialType)
 	{
-	case SURFACE_Concrete:	ImpactSound = ConcreteSound; break;
-	case SURFACE_Dirt:		ImpactSound = DirtSound; break;
-	case SURFACE_Water:		ImpactSound = WaterSound; break;
-	case SURFACE_Metal:		ImpactSound = MetalSound; break;
-	case SURFACE_Wood:		ImpactSound = WoodSound; break;
-	case SURFACE_Grass:		ImpactSound = GrassSound; break;
-	case SURFACE_Glass:		ImpactSound = GlassSound; break;
-	case SURFACE_Flesh:		ImpactSound = FleshSound; break;
+	case EPhysMaterialType::Concrete:	ImpactSound = ConcreteSound; break;
+	case EPhysMaterialType::Dirt:	ImpactSound = DirtSound; break;
+	case EPhysMaterialType::Water:	ImpactSound = WaterSound; break;
+	case EPhysMaterialType::Metal:	ImpactSound = MetalSound; break;
+	case EPhysMaterialType::Wood:	ImpactSound = WoodSound; break;
+	case EPhysMaterialType::Grass:	ImpactSound = GrassSound; break;
+	case EPhysMaterialType::Glass:	ImpactSound = GlassSound; break;
+	case EPhysMaterialType::Flesh:	ImpactSound = FleshSound; break;
 	default:						ImpactSound = DefaultSound; break;
 	}
 
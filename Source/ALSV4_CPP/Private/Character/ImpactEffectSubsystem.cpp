@@ -0,0 +1,368 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "Character/ImpactEffectSubsystem.h"
+#include "Character/ImpactEffect.h"
+#include "Components/AudioComponent.h"
+#include "Components/DecalComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Spawn Impact"), STAT_ImpactEffectSpawn, STATGROUP_ImpactEffects);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impacts Culled"), STAT_ImpactEffectCulled, STATGROUP_ImpactEffects);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Components"), STAT_ImpactEffectPooled, STATGROUP_ImpactEffects);
+
+namespace ImpactEffectCVars
+{
+	static int32 MaxEffectsPerMaterial = 8;
+	FAutoConsoleVariableRef CVarMaxEffectsPerMaterial(
+		TEXT("fx.Impact.MaxEffectsPerMaterial"),
+		MaxEffectsPerMaterial,
+		TEXT("Particle and audio components kept per material type. Once reached the oldest playing one is restarted."),
+		ECVF_Default);
+
+	static int32 MaxDecals = 64;
+	FAutoConsoleVariableRef CVarMaxDecals(
+		TEXT("fx.Impact.MaxDecals"),
+		MaxDecals,
+		TEXT("Number of most recent impact decals kept in the world."),
+		ECVF_Default);
+
+	static float CullDistance = 5000.0f;
+	FAutoConsoleVariableRef CVarCullDistance(
+		TEXT("fx.Impact.CullDistance"),
+		CullDistance,
+		TEXT("Impacts further than this from every local view are not played. 0 disables culling."),
+		ECVF_Default);
+}
+
+FImpactEffectRequest::FImpactEffectRequest(TSubclassOf<AImpactEffect> InTemplate, const FHitResult& Impact)
+	: Template(InTemplate)
+	, MaterialType(GetMaterialType(UPhysicalMaterial::DetermineSurfaceType(Impact.PhysMaterial.Get())))
+	, Location(Impact.ImpactPoint)
+	, Normal(Impact.ImpactNormal)
+	, Component(Impact.Component)
+	, BoneName(Impact.BoneName)
+{
+}
+
+EPhysMaterialType::Type FImpactEffectRequest::GetMaterialType(EPhysicalSurface SurfaceType)
+{
+	// SURFACE_* are declared in the same order as the material types, starting at SurfaceType1
+	if (SurfaceType >= SURFACE_Concrete && SurfaceType <= SURFACE_Flesh)
+	{
+		return (EPhysMaterialType::Type)(EPhysMaterialType::Concrete + (SurfaceType - SURFACE_Concrete));
+	}
+
+	return EPhysMaterialType::Unknown;
+}
+
+bool UImpactEffectSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// nobody sees or hears impacts on a dedicated server
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UImpactEffectSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Pools.SetNum(EPhysMaterialType::Flesh + 1);
+	NextDecal = 0;
+}
+
+void UImpactEffectSubsystem::Deinitialize()
+{
+	for (FImpactEffectPool& Pool : Pools)
+	{
+		for (UParticleSystemComponent* PSC : Pool.Particles)
+		{
+			if (PSC)
+			{
+				PSC->DestroyComponent();
+			}
+		}
+
+		for (UAudioComponent* AC : Pool.Sounds)
+		{
+			if (AC)
+			{
+				AC->DestroyComponent();
+			}
+		}
+	}
+
+	for (UDecalComponent* Decal : Decals)
+	{
+		if (Decal)
+		{
+			Decal->DestroyComponent();
+		}
+	}
+
+	Pools.Reset();
+	Decals.Reset();
+	DecalExpireTimes.Reset();
+
+	Super::Deinitialize();
+}
+
+UImpactEffectSubsystem* UImpactEffectSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UImpactEffectSubsystem>() : nullptr;
+}
+
+void UImpactEffectSubsystem::SpawnImpact(const FImpactEffectRequest& Request)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ImpactEffectSpawn);
+
+	const AImpactEffect* EffectDefaults = Request.Template ? Request.Template->GetDefaultObject<AImpactEffect>() : nullptr;
+	if (!EffectDefaults || !Pools.IsValidIndex(Request.MaterialType))
+	{
+		return;
+	}
+
+	if (!IsWithinCullDistance(Request.Location))
+	{
+		INC_DWORD_STAT(STAT_ImpactEffectCulled);
+		return;
+	}
+
+	FImpactEffectPool& Pool = Pools[Request.MaterialType];
+	const FRotator ImpactRotation = Request.Normal.Rotation();
+
+	// show particles
+	UParticleSystem* ImpactFX = EffectDefaults->GetImpactFX(Request.MaterialType);
+	if (ImpactFX)
+	{
+		UParticleSystemComponent* PSC = AcquireParticles(Pool, ImpactFX);
+		if (PSC)
+		{
+			PSC->SetWorldLocationAndRotation(Request.Location, ImpactRotation);
+			PSC->Activate(true);
+		}
+	}
+
+	// play sound
+	USoundCue* ImpactSound = EffectDefaults->GetImpactSound(Request.MaterialType);
+	if (ImpactSound)
+	{
+		UAudioComponent* AC = AcquireSound(Pool);
+		if (AC)
+		{
+			AC->SetSound(ImpactSound);
+			AC->SetWorldLocation(Request.Location);
+			AC->Play();
+		}
+	}
+
+	const FDecalData& DecalData = EffectDefaults->DefaultDecal;
+	if (DecalData.DecalMaterial)
+	{
+		UDecalComponent* Decal = AcquireDecal(DecalData.LifeSpan);
+		if (Decal)
+		{
+			FRotator RandomDecalRotation = ImpactRotation;
+			RandomDecalRotation.Roll = FMath::FRandRange(-180.0f, 180.0f);
+
+			Decal->SetDecalMaterial(DecalData.DecalMaterial);
+			Decal->DecalSize = FVector(1.0f, DecalData.DecalSize, DecalData.DecalSize);
+			Decal->SetWorldLocationAndRotation(Request.Location, RandomDecalRotation);
+
+			// only follow components that can actually move, static geometry never needs the attachment
+			UPrimitiveComponent* HitComponent = Request.Component.Get();
+			if (HitComponent && HitComponent->Mobility == EComponentMobility::Movable)
+			{
+				Decal->AttachToComponent(HitComponent, FAttachmentTransformRules::KeepWorldTransform, Request.BoneName);
+			}
+
+			Decal->SetVisibility(true);
+			Decal->MarkRenderStateDirty();
+		}
+	}
+}
+
+UParticleSystemComponent* UImpactEffectSubsystem::AcquireParticles(FImpactEffectPool& Pool, UParticleSystem* Template)
+{
+	// idle with the same template first, it can be restarted without rebuilding its emitters
+	UParticleSystemComponent* IdlePSC = nullptr;
+	for (UParticleSystemComponent* PSC : Pool.Particles)
+	{
+		if (PSC && !PSC->IsActive())
+		{
+			if (PSC->Template == Template)
+			{
+				return PSC;
+			}
+			IdlePSC = IdlePSC ? IdlePSC : PSC;
+		}
+	}
+
+	if (!IdlePSC)
+	{
+		if (Pool.Particles.Num() < ImpactEffectCVars::MaxEffectsPerMaterial)
+		{
+			IdlePSC = NewObject<UParticleSystemComponent>(GetWorld());
+			IdlePSC->bAutoActivate = false;
+			IdlePSC->bAutoDestroy = false;
+			IdlePSC->SetUsingAbsoluteLocation(true);
+			IdlePSC->SetUsingAbsoluteRotation(true);
+			IdlePSC->SetUsingAbsoluteScale(true);
+			IdlePSC->RegisterComponentWithWorld(GetWorld());
+			Pool.Particles.Add(IdlePSC);
+			INC_DWORD_STAT(STAT_ImpactEffectPooled);
+		}
+		else if (Pool.Particles.Num() > 0)
+		{
+			// over budget, restart the oldest one still playing
+			Pool.NextParticle = Pool.NextParticle % Pool.Particles.Num();
+			IdlePSC = Pool.Particles[Pool.NextParticle++];
+		}
+	}
+
+	if (IdlePSC && IdlePSC->Template != Template)
+	{
+		IdlePSC->SetTemplate(Template);
+	}
+
+	return IdlePSC;
+}
+
+UAudioComponent* UImpactEffectSubsystem::AcquireSound(FImpactEffectPool& Pool)
+{
+	for (UAudioComponent* AC : Pool.Sounds)
+	{
+		if (AC && !AC->IsPlaying())
+		{
+			return AC;
+		}
+	}
+
+	if (Pool.Sounds.Num() < ImpactEffectCVars::MaxEffectsPerMaterial)
+	{
+		UAudioComponent* AC = NewObject<UAudioComponent>(GetWorld());
+		AC->bAutoActivate = false;
+		AC->bAutoDestroy = false;
+		AC->bAllowSpatialization = true;
+		AC->SetUsingAbsoluteLocation(true);
+		AC->RegisterComponentWithWorld(GetWorld());
+		Pool.Sounds.Add(AC);
+		INC_DWORD_STAT(STAT_ImpactEffectPooled);
+		return AC;
+	}
+
+	if (Pool.Sounds.Num() > 0)
+	{
+		Pool.NextSound = Pool.NextSound % Pool.Sounds.Num();
+		return Pool.Sounds[Pool.NextSound++];
+	}
+
+	return nullptr;
+}
+
+UDecalComponent* UImpactEffectSubsystem::AcquireDecal(float LifeSpan)
+{
+	const int32 MaxDecals = ImpactEffectCVars::MaxDecals;
+	if (MaxDecals <= 0)
+	{
+		return nullptr;
+	}
+
+	// budget lowered at runtime, drop the extra decals
+	while (Decals.Num() > MaxDecals)
+	{
+		if (Decals.Last())
+		{
+			Decals.Last()->DestroyComponent();
+			DEC_DWORD_STAT(STAT_ImpactEffectPooled);
+		}
+		Decals.Pop();
+		DecalExpireTimes.Pop();
+	}
+
+	NextDecal = NextDecal % MaxDecals;
+
+	UDecalComponent* Decal = nullptr;
+	if (NextDecal >= Decals.Num())
+	{
+		Decal = NewObject<UDecalComponent>(GetWorld());
+		Decal->bAutoActivate = false;
+		Decal->RegisterComponentWithWorld(GetWorld());
+		Decals.Add(Decal);
+		DecalExpireTimes.Add(0.0f);
+		INC_DWORD_STAT(STAT_ImpactEffectPooled);
+	}
+	else
+	{
+		// oldest decal in the ring, take it off whatever it was stuck to
+		Decal = Decals[NextDecal];
+		Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+
+	DecalExpireTimes[NextDecal] = LifeSpan > 0.0f ? GetWorld()->GetTimeSeconds() + LifeSpan : MAX_flt;
+	NextDecal++;
+
+	if (!GetWorld()->GetTimerManager().IsTimerActive(TimerHandle_ExpireDecals))
+	{
+		GetWorld()->GetTimerManager().SetTimer(TimerHandle_ExpireDecals, this, &UImpactEffectSubsystem::ExpireDecals, 1.0f, true);
+	}
+
+	return Decal;
+}
+
+void UImpactEffectSubsystem::ExpireDecals()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	bool bAnyVisible = false;
+
+	for (int32 Index = 0; Index < Decals.Num(); ++Index)
+	{
+		UDecalComponent* Decal = Decals[Index];
+		if (Decal && Decal->IsVisible())
+		{
+			if (DecalExpireTimes[Index] <= TimeSeconds)
+			{
+				Decal->SetVisibility(false);
+				Decal->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+			}
+			else
+			{
+				bAnyVisible = true;
+			}
+		}
+	}
+
+	if (!bAnyVisible)
+	{
+		GetWorld()->GetTimerManager().ClearTimer(TimerHandle_ExpireDecals);
+	}
+}
+
+bool UImpactEffectSubsystem::IsWithinCullDistance(const FVector& Location) const
+{
+	const float CullDistance = ImpactEffectCVars::CullDistance;
+	if (CullDistance <= 0.0f)
+	{
+		return true;
+	}
+
+	bool bHasView = false;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			bHasView = true;
+			if (FVector::DistSquared(PC->PlayerCameraManager->GetCameraLocation(), Location) <= FMath::Square(CullDistance))
+			{
+				return true;
+			}
+		}
+	}
+
+	// no local view to measure from, don't hide anything
+	return !bHasView;
+}
@@ -9,6 +9,7 @@
 #include "Net/UnrealNetwork.h"
 #include "Components/AudioComponent.h"
 #include "Character/ALSBaseCharacter.h"
+#include "Character/WeaponFXSubsystem.h"
 #include "DependencyFix/Public/PhysicsObject.h"
 #include "DependencyFix/Public/PhysicsItem.h"
 #include "DrawDebugHelpers.h"
@@ -55,6 +56,7 @@ AWeapon::AWeapon(const FObjectInitializer& ObjectInitializer) : Super(ObjectInit
 	CurrentAmmoInClip = 0;
 	BurstCounter = 0;
 	LastFireTime = 0.0f;
+	PendingSubFrameShots = 0;
 
 
 	PrimaryActorTick.bCanEverTick = true;
@@ -452,6 +454,13 @@ void AWeapon::HandleReFiring()
 
 	if (bAllowAutomaticWeaponCatchup)
 	{
+		// whole shots lost to a long frame are fired now, only the remainder shortens the next refire
+		if (WeaponConfig.TimeBetweenShots > 0.0f)
+		{
+			PendingSubFrameShots = FMath::Min(FMath::FloorToInt(SlackTimeThisFrame / WeaponConfig.TimeBetweenShots), WeaponConfig.MaxShotsPerFrame - 1);
+			SlackTimeThisFrame -= PendingSubFrameShots * WeaponConfig.TimeBetweenShots;
+		}
+
 		TimerIntervalAdjustment -= SlackTimeThisFrame;
 	}
 
@@ -460,6 +469,8 @@ void AWeapon::HandleReFiring()
 
 void AWeapon::HandleFiring()
 {
+	uint8 NumShotsFired = 1;
+
 	if ((CurrentAmmoInClip > 0 || HasInfiniteClip() || HasInfiniteAmmo()) && CanFire())
 	{
 		if (GetNetMode() != NM_DedicatedServer)
@@ -469,12 +480,23 @@ void AWeapon::HandleFiring()
 
 		if (MyPawn && MyPawn->IsLocallyControlled())
 		{
-			FireWeapon();
+			// fire this shot and any that came due since the last refire, they reach the server as one batch
+			const int32 NumShots = 1 + PendingSubFrameShots;
+			NumShotsFired = 0;
 
-			UseAmmo();
+			do
+			{
+				FireWeapon();
 
-			// update firing FX on remote clients if function was called on server
-			BurstCounter++;
+				UseAmmo();
+
+				// update firing FX on remote clients if function was called on server
+				BurstCounter++;
+				NumShotsFired++;
+			}
+			while (NumShotsFired < NumShots && (CurrentAmmoInClip > 0 || HasInfiniteClip() || HasInfiniteAmmo()));
+
+			FlushFiredShots();
 		}
 	}
 	else if (CanReload())
@@ -505,12 +527,15 @@ void AWeapon::HandleFiring()
 		OnBurstFinished();
 	}
 
+	// shots due this frame were fired above or dropped with the burst
+	PendingSubFrameShots = 0;
+
 	if (MyPawn && MyPawn->IsLocallyControlled())
 	{
 		// local client will notify server
 		if (GetLocalRole() < ROLE_Authority)
 		{
-			ServerHandleFiring();
+			ServerHandleFiring(NumShotsFired);
 		}
 
 		// reload after firing last round
@@ -531,12 +556,12 @@ void AWeapon::HandleFiring()
 	LastFireTime = GetWorld()->GetTimeSeconds();
 }
 
-bool AWeapon::ServerHandleFiring_Validate()
+bool AWeapon::ServerHandleFiring_Validate(uint8 NumShots)
 {
 	return true;
 }
 
-void AWeapon::ServerHandleFiring_Implementation()
+void AWeapon::ServerHandleFiring_Implementation(uint8 NumShots)
 {
 	const bool bShouldUpdateAmmo = (CurrentAmmoInClip > 0 && CanFire());
 
@@ -544,11 +569,15 @@ void AWeapon::ServerHandleFiring_Implementation()
 
 	if (bShouldUpdateAmmo)
 	{
-		// update ammo
-		UseAmmo();
+		// update ammo for every shot the client fired this frame, but never more than the weapon allows
+		const int32 NumShotsToApply = FMath::Clamp<int32>(NumShots, 1, WeaponConfig.MaxShotsPerFrame);
+		for (int32 ShotIndex = 0; ShotIndex < NumShotsToApply && CurrentAmmoInClip > 0; ++ShotIndex)
+		{
+			UseAmmo();
 
-		// update firing FX on remote clients
-		BurstCounter++;
+			// update firing FX on remote clients
+			BurstCounter++;
+		}
 	}
 }
 
@@ -876,7 +905,7 @@ void AWeapon::SimulateWeaponFire()
 	if (MuzzleFX)
 	{
 		USkeletalMeshComponent* UseWeaponMesh = GetWeaponMesh();
-		if (!bLoopedMuzzleFX || MuzzlePSC == NULL)
+		if (!bLoopedMuzzleFX || MuzzlePSC == NULL || !MuzzlePSC->IsActive())
 		{
 			// Split screen requires we create 2 effects. One that we see and one that the other player sees.
 			if ((MyPawn != NULL) && (MyPawn->IsLocallyControlled() == true))
@@ -884,20 +913,41 @@ void AWeapon::SimulateWeaponFire()
 				AController* PlayerCon = MyPawn->GetController();
 				if (PlayerCon != NULL)
 				{
-					Mesh1P->GetSocketLocation(MuzzleAttachPoint);
-					MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh1P, MuzzleAttachPoint);
-					MuzzlePSC->bOwnerNoSee = false;
-					MuzzlePSC->bOnlyOwnerSee = true;
-
-					Mesh3P->GetSocketLocation(MuzzleAttachPoint);
-					MuzzlePSCSecondary = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh3P, MuzzleAttachPoint);
-					MuzzlePSCSecondary->bOwnerNoSee = true;
-					MuzzlePSCSecondary->bOnlyOwnerSee = false;
+					// owner visibility needs components owned by this weapon, so the pair is kept and restarted instead of pooled
+					if (MuzzlePSC == NULL || MuzzlePSC->GetOwner() != this)
+					{
+						MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh1P, MuzzleAttachPoint,
+							FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, false);
+						MuzzlePSC->bOwnerNoSee = false;
+						MuzzlePSC->bOnlyOwnerSee = true;
+					}
+					else
+					{
+						MuzzlePSC->ActivateSystem(true);
+					}
+
+					if (MuzzlePSCSecondary == NULL)
+					{
+						MuzzlePSCSecondary = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, Mesh3P, MuzzleAttachPoint,
+							FVector::ZeroVector, FRotator::ZeroRotator, EAttachLocation::KeepRelativeOffset, false);
+						MuzzlePSCSecondary->bOwnerNoSee = true;
+						MuzzlePSCSecondary->bOnlyOwnerSee = false;
+					}
+					else
+					{
+						MuzzlePSCSecondary->ActivateSystem(true);
+					}
 				}
 			}
 			else
 			{
-				MuzzlePSC = UGameplayStatics::SpawnEmitterAttached(MuzzleFX, UseWeaponMesh, MuzzleAttachPoint);
+				// remote weapons share the class pool, only looping flashes need to be stopped later
+				UWeaponFXSubsystem* WeaponFX = UWeaponFXSubsystem::Get(this);
+				UParticleSystemComponent* PooledPSC = WeaponFX ? WeaponFX->SpawnMuzzleFlash(this, MuzzleFX, UseWeaponMesh, MuzzleAttachPoint) : NULL;
+				if (bLoopedMuzzleFX)
+				{
+					MuzzlePSC = PooledPSC;
+				}
 			}
 		}
 	}
@@ -942,15 +992,18 @@ void AWeapon::StopSimulatingWeaponFire()
 {
 	if (bLoopedMuzzleFX)
 	{
+		// our own components are restarted on the next burst, pooled ones go back to the pool
 		if (MuzzlePSC != NULL)
 		{
 			MuzzlePSC->DeactivateSystem();
-			MuzzlePSC = NULL;
+			if (MuzzlePSC->GetOwner() != this)
+			{
+				MuzzlePSC = NULL;
+			}
 		}
 		if (MuzzlePSCSecondary != NULL)
 		{
 			MuzzlePSCSecondary->DeactivateSystem();
-			MuzzlePSCSecondary = NULL;
 		}
 	}
 
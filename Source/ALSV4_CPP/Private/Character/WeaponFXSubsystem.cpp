@@ -0,0 +1,212 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#include "Character/WeaponFXSubsystem.h"
+#include "Character/Weapon.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Hits"), STAT_WeaponFXPoolHits, STATGROUP_WeaponFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Misses"), STAT_WeaponFXPoolMisses, STATGROUP_WeaponFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped (Budget)"), STAT_WeaponFXDroppedBudget, STATGROUP_WeaponFX);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dropped (Culled)"), STAT_WeaponFXDroppedCulled, STATGROUP_WeaponFX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Components"), STAT_WeaponFXPooled, STATGROUP_WeaponFX);
+
+namespace WeaponFXCVars
+{
+	static int32 MaxTrailsPerClass = 16;
+	FAutoConsoleVariableRef CVarMaxTrailsPerClass(
+		TEXT("fx.WeaponFX.MaxTrailsPerClass"),
+		MaxTrailsPerClass,
+		TEXT("Trail components kept per weapon class. Trails needing more are dropped."),
+		ECVF_Default);
+
+	static int32 MaxMuzzleFlashesPerClass = 8;
+	FAutoConsoleVariableRef CVarMaxMuzzleFlashesPerClass(
+		TEXT("fx.WeaponFX.MaxMuzzleFlashesPerClass"),
+		MaxMuzzleFlashesPerClass,
+		TEXT("Muzzle flash components kept per weapon class. Flashes needing more are dropped."),
+		ECVF_Default);
+
+	static float CullDistance = 8000.0f;
+	FAutoConsoleVariableRef CVarCullDistance(
+		TEXT("fx.WeaponFX.CullDistance"),
+		CullDistance,
+		TEXT("Trails and muzzle flashes further than this from every local view are dropped. 0 disables culling."),
+		ECVF_Default);
+
+	static float OffscreenTolerance = 0.2f;
+	FAutoConsoleVariableRef CVarOffscreenTolerance(
+		TEXT("fx.WeaponFX.OffscreenTolerance"),
+		OffscreenTolerance,
+		TEXT("Muzzle flashes are dropped when the weapon mesh hasn't been rendered for this many seconds. 0 disables the check."),
+		ECVF_Default);
+}
+
+bool UWeaponFXSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// nobody sees cosmetic FX on a dedicated server
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UWeaponFXSubsystem::Deinitialize()
+{
+	for (TPair<UClass*, FWeaponFXPool>& Pair : Pools)
+	{
+		for (UParticleSystemComponent* PSC : Pair.Value.Trails)
+		{
+			if (PSC)
+			{
+				PSC->DestroyComponent();
+			}
+		}
+
+		for (UParticleSystemComponent* PSC : Pair.Value.MuzzleFlashes)
+		{
+			if (PSC)
+			{
+				PSC->DestroyComponent();
+			}
+		}
+	}
+
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+UWeaponFXSubsystem* UWeaponFXSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UWeaponFXSubsystem>() : nullptr;
+}
+
+UParticleSystemComponent* UWeaponFXSubsystem::SpawnTrail(const AWeapon* Weapon, UParticleSystem* Template,
+	const FVector& Origin, const FVector& EndPoint, FName TargetParam)
+{
+	if (!Weapon || !Template)
+	{
+		return nullptr;
+	}
+
+	// the whole trail counts, a shot fired from far away can still pass right by the camera
+	const float CullDistance = WeaponFXCVars::CullDistance;
+	if (CullDistance > 0.0f && GetViewDistSquared(Origin, EndPoint) > FMath::Square(CullDistance))
+	{
+		INC_DWORD_STAT(STAT_WeaponFXDroppedCulled);
+		return nullptr;
+	}
+
+	FWeaponFXPool& Pool = Pools.FindOrAdd(Weapon->GetClass());
+	UParticleSystemComponent* TrailPSC = Acquire(Pool.Trails, WeaponFXCVars::MaxTrailsPerClass, Template);
+	if (TrailPSC)
+	{
+		TrailPSC->SetWorldLocationAndRotation(Origin, FRotator::ZeroRotator);
+		TrailPSC->SetVectorParameter(TargetParam, EndPoint);
+		TrailPSC->Activate(true);
+	}
+
+	return TrailPSC;
+}
+
+UParticleSystemComponent* UWeaponFXSubsystem::SpawnMuzzleFlash(const AWeapon* Weapon, UParticleSystem* Template,
+	UPrimitiveComponent* AttachTo, FName AttachPoint)
+{
+	if (!Weapon || !Template || !AttachTo)
+	{
+		return nullptr;
+	}
+
+	const float OffscreenTolerance = WeaponFXCVars::OffscreenTolerance;
+	const float CullDistance = WeaponFXCVars::CullDistance;
+	const FVector MuzzleLocation = AttachTo->GetSocketLocation(AttachPoint);
+	if ((OffscreenTolerance > 0.0f && !AttachTo->WasRecentlyRendered(OffscreenTolerance)) ||
+		(CullDistance > 0.0f && GetViewDistSquared(MuzzleLocation, MuzzleLocation) > FMath::Square(CullDistance)))
+	{
+		INC_DWORD_STAT(STAT_WeaponFXDroppedCulled);
+		return nullptr;
+	}
+
+	FWeaponFXPool& Pool = Pools.FindOrAdd(Weapon->GetClass());
+	UParticleSystemComponent* MuzzlePSC = Acquire(Pool.MuzzleFlashes, WeaponFXCVars::MaxMuzzleFlashesPerClass, Template);
+	if (MuzzlePSC)
+	{
+		MuzzlePSC->SetUsingAbsoluteLocation(false);
+		MuzzlePSC->SetUsingAbsoluteRotation(false);
+		MuzzlePSC->AttachToComponent(AttachTo, FAttachmentTransformRules::SnapToTargetNotIncludingScale, AttachPoint);
+		MuzzlePSC->Activate(true);
+	}
+
+	return MuzzlePSC;
+}
+
+UParticleSystemComponent* UWeaponFXSubsystem::Acquire(TArray<UParticleSystemComponent*>& Components,
+	int32 MaxComponents, UParticleSystem* Template)
+{
+	// forget components that went away with a level or a weapon they were attached to
+	Components.RemoveAll([](const UParticleSystemComponent* PSC) { return PSC == nullptr || PSC->IsPendingKill(); });
+
+	// idle with the same template first, it can be restarted without rebuilding its emitters
+	UParticleSystemComponent* IdlePSC = nullptr;
+	for (UParticleSystemComponent* PSC : Components)
+	{
+		if (!PSC->IsActive())
+		{
+			if (PSC->Template == Template)
+			{
+				IdlePSC = PSC;
+				break;
+			}
+			IdlePSC = IdlePSC ? IdlePSC : PSC;
+		}
+	}
+
+	if (IdlePSC)
+	{
+		INC_DWORD_STAT(STAT_WeaponFXPoolHits);
+		IdlePSC->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	}
+	else if (Components.Num() < MaxComponents)
+	{
+		INC_DWORD_STAT(STAT_WeaponFXPoolMisses);
+		INC_DWORD_STAT(STAT_WeaponFXPooled);
+
+		IdlePSC = NewObject<UParticleSystemComponent>(GetWorld());
+		IdlePSC->bAutoActivate = false;
+		IdlePSC->bAutoDestroy = false;
+		IdlePSC->RegisterComponentWithWorld(GetWorld());
+		Components.Add(IdlePSC);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_WeaponFXDroppedBudget);
+		return nullptr;
+	}
+
+	// trails are placed in world space, muzzle flashes switch back to relative when attached
+	IdlePSC->SetUsingAbsoluteLocation(true);
+	IdlePSC->SetUsingAbsoluteRotation(true);
+	if (IdlePSC->Template != Template)
+	{
+		IdlePSC->SetTemplate(Template);
+	}
+
+	return IdlePSC;
+}
+
+float UWeaponFXSubsystem::GetViewDistSquared(const FVector& Start, const FVector& End) const
+{
+	float BestDistSquared = MAX_flt;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+		{
+			const FVector ViewLocation = PC->PlayerCameraManager->GetCameraLocation();
+			BestDistSquared = FMath::Min(BestDistSquared, FMath::PointDistToSegmentSquared(ViewLocation, Start, End));
+		}
+	}
+
+	// no local view to measure from, don't hide anything
+	return BestDistSquared == MAX_flt ? 0.0f : BestDistSquared;
+}
@@ -0,0 +1,151 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Copyright:       Copyright (C) 2020 Doğa Can Yanıkoğlu
+// License:         MIT License (http://www.opensource.org/licenses/mit-license.php)
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:    
+
+
+#include "Library/ALSCharacterStructLibrary.h"
+
+namespace ALSReplicatedEssentials
+{
+	enum EField : uint8
+	{
+		Field_CurrentAcceleration = 1 << 0,
+		Field_ControlRotation = 1 << 1,
+		Field_GravityDirection = 1 << 2,
+		Field_QuatYawRotation = 1 << 3,
+
+		Field_All = Field_CurrentAcceleration | Field_ControlRotation | Field_GravityDirection | Field_QuatYawRotation,
+	};
+
+	static const uint32 FieldCount = 4;
+
+	// Tolerances match the quantization each field is written with, anything smaller would not survive the trip
+	static const float AccelerationTolerance = 0.1f;
+	static const float GravityDirectionTolerance = 1.f / 32767.f;
+	static const float RotationTolerance = 360.f / 65536.f;
+
+	static uint8 GetDirtyMask(const FALSReplicatedEssentials& Base, const FALSReplicatedEssentials& Current)
+	{
+		uint8 Mask = 0;
+
+		if (!Current.CurrentAcceleration.Equals(Base.CurrentAcceleration, AccelerationTolerance))
+		{
+			Mask |= Field_CurrentAcceleration;
+		}
+		if (!Current.ControlRotation.Equals(Base.ControlRotation, RotationTolerance))
+		{
+			Mask |= Field_ControlRotation;
+		}
+		if (!Current.GravityDirection.Equals(Base.GravityDirection, GravityDirectionTolerance))
+		{
+			Mask |= Field_GravityDirection;
+		}
+		if (!Current.QuatYawRotation.Equals(Base.QuatYawRotation, RotationTolerance))
+		{
+			Mask |= Field_QuatYawRotation;
+		}
+
+		return Mask;
+	}
+
+	// Values as the receiving end of one connection last acknowledged them
+	class FDeltaState : public INetDeltaBaseState
+	{
+	public:
+
+		virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override
+		{
+			return GetDirtyMask(static_cast<FDeltaState*>(OtherState)->Essentials, Essentials) == 0;
+		}
+
+		FALSReplicatedEssentials Essentials;
+	};
+}
+
+bool FALSReplicatedEssentials::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+{
+	using namespace ALSReplicatedEssentials;
+
+	if (DeltaParms.Writer)
+	{
+		FBitWriter& Writer = *DeltaParms.Writer;
+		const FDeltaState* OldState = static_cast<const FDeltaState*>(DeltaParms.OldState);
+
+		uint8 DirtyMask = OldState ? GetDirtyMask(OldState->Essentials, *this) : Field_All;
+		if (DirtyMask == 0)
+		{
+			return false;
+		}
+
+		// Clean fields keep the acknowledged value, so slow drift is still measured against what the client has
+		TSharedPtr<FDeltaState> NewState = MakeShared<FDeltaState>();
+		NewState->Essentials = OldState ? OldState->Essentials : *this;
+		*DeltaParms.NewState = NewState;
+
+		Writer.SerializeBits(&DirtyMask, FieldCount);
+
+		bool bSuccess = true;
+		if (DirtyMask & Field_CurrentAcceleration)
+		{
+			FVector_NetQuantize10 Acceleration = CurrentAcceleration;
+			Acceleration.NetSerialize(Writer, DeltaParms.Map, bSuccess);
+			NewState->Essentials.CurrentAcceleration = CurrentAcceleration;
+		}
+		if (DirtyMask & Field_ControlRotation)
+		{
+			ControlRotation.SerializeCompressedShort(Writer);
+			NewState->Essentials.ControlRotation = ControlRotation;
+		}
+		if (DirtyMask & Field_GravityDirection)
+		{
+			FVector_NetQuantizeNormal Gravity = GravityDirection;
+			Gravity.NetSerialize(Writer, DeltaParms.Map, bSuccess);
+			NewState->Essentials.GravityDirection = GravityDirection;
+		}
+		if (DirtyMask & Field_QuatYawRotation)
+		{
+			QuatYawRotation.SerializeCompressedShort(Writer);
+			NewState->Essentials.QuatYawRotation = QuatYawRotation;
+		}
+
+		return bSuccess;
+	}
+
+	if (DeltaParms.Reader)
+	{
+		FBitReader& Reader = *DeltaParms.Reader;
+
+		uint8 DirtyMask = 0;
+		Reader.SerializeBits(&DirtyMask, FieldCount);
+
+		bool bSuccess = true;
+		if (DirtyMask & Field_CurrentAcceleration)
+		{
+			FVector_NetQuantize10 Acceleration;
+			Acceleration.NetSerialize(Reader, DeltaParms.Map, bSuccess);
+			CurrentAcceleration = Acceleration;
+		}
+		if (DirtyMask & Field_ControlRotation)
+		{
+			ControlRotation.SerializeCompressedShort(Reader);
+		}
+		if (DirtyMask & Field_GravityDirection)
+		{
+			FVector_NetQuantizeNormal Gravity;
+			Gravity.NetSerialize(Reader, DeltaParms.Map, bSuccess);
+			GravityDirection = Gravity;
+		}
+		if (DirtyMask & Field_QuatYawRotation)
+		{
+			QuatYawRotation.SerializeCompressedShort(Reader);
+		}
+
+		return bSuccess && !Reader.IsError();
+	}
+
+	// No object references to gather or remap
+	return false;
+}
@@ -9,7 +9,6 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "Components/TimelineComponent.h"
 #include "Library/ALSCharacterEnumLibrary.h"
 #include "Library/ALSCharacterStructLibrary.h"
 #include "Engine/DataTable.h"
@@ -28,7 +27,6 @@ DECLARE_MULTICAST_DELEGATE_TwoParams(FOnUnEquipWeapon, AALSBaseCharacter*, AWeap
 class AWeapon;
 class APhysicsItem;
 class ASingleShotTestGun;
-class UTimelineComponent;
 class UAnimInstance;
 class UAnimMontage;
 class UALSCharacterAnimInstance;
@@ -50,6 +48,10 @@ class ALSV4_CPP_API AALSBaseCharacter : public ACharacter, public IPhysicsInterf
 
 	UPROPERTY(VisibleAnywhere)
 		class UStaticMeshComponent* CameraPoll;
+
+	/** Server side hitbox history that client hits on this character are validated against */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "ALS|Components", meta = (AllowPrivateAccess = "true"))
+		class UALSHitboxHistoryComponent* HitboxHistory;
 	
 		UCapsuleComponent* CapsuleComponent;
 	/** get max health */
@@ -86,13 +88,6 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "ID", Replicated)
 		uint8 PlayerID;
 		
-	UFUNCTION(Reliable, Client)
-	void ClientCalculateFlow(ARoomDataHelper* DataHelper, const TArray<FFloatBool>& AirCurrentData) const;
-
-	
-	UFUNCTION(reliable, server, WithValidation)
-		void ServerUpdateFlow(const FCompressedForceArray& OutCompressedForceArray, ARoomDataHelper* BroadcastingDataHelper);
-		
 	//GasSystem: 
 	//UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_LocalForces, Category = "ALS|Essential Information")
 	TArray<FVector> LocalForces; 
@@ -101,8 +96,8 @@ public:
 	
 
 	float BrakingDecelerationFlying;
-	int32 GetCurrentRoomID();
-	int32 GetPredictedNextRoomID();
+	int32 GetCurrentRoomID() const;
+	int32 GetPredictedNextRoomID() const;
 	void SetPredictedRoomID(int32 NewRoomID);
 	void SetCurrentRoomID(int32 NewRoomID);
 	void SetCurrentRoomIDToPredicted();
@@ -121,9 +116,9 @@ public:
 	/** Returns True if the pawn can die in the current state */
 	virtual bool CanDie(float KillingDamage, FDamageEvent const& DamageEvent, AController* Killer, AActor* DamageCauser) const;
 
-	FVector NewWindForce = FVector::ZeroVector;
-	FVector WindForce = FVector::ZeroVector;
-	FVector OldWindForce = FVector::ZeroVector;
+	// Wind handed to us by UALSWindFieldSubsystem before actors tick
+	FALSWindFieldSample WindFieldSample;
+
 	/**
 	* Kills pawn.  Server/authority only.
 	* @param KillingDamage - Damage amount of the killing blow
@@ -230,6 +225,17 @@ public:
 
 	FVector GravityDirection;
 
+	// Constant push of the entanglement or scripted force channel (Server only)
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Movement")
+		void SetChannelForce(EALSForceChannel Channel, FVector Force);
+
+	// Parameters the movement component evaluates its force channels from, on the server and the owning client alike
+	UPROPERTY(BlueprintReadOnly, Replicated, Category = "Movement")
+		FALSForceChannels ForceChannels;
+
+	// World time of the last Gravitate call, the gravity well is released once they stop (Server only)
+	float LastGravitateTime = 0.0f;
+
 	virtual void Tick(float DeltaTime) override;
 
 	virtual void BeginPlay() override;
@@ -259,11 +265,17 @@ public:
 	UFUNCTION(BlueprintCallable, Server, Unreliable, Category = "ALS|Ragdoll System")
 	void Server_SetMeshLocationDuringRagdoll(FVector MeshLocation);
 
-	UFUNCTION(BlueprintCallable, Server, Unreliable, Category = "Camera System")
-		void Server_SetCameraRotation(FRotator Rot);
+	/** Server side reconstruction of the aim carried by the owning client's moves */
+	void ApplyMoveAim(const FRotator& NewCameraRotation, const FRotator& NewCameraPollRotation);
+
+	/** Server side application of the desired states carried by the owning client's moves */
+	void ApplyMoveDesiredStates(EALSGait NewGait, EALSStance NewStance, EALSRotationMode NewRotMode);
 
-	UFUNCTION(BlueprintCallable, Server, Unreliable, Category = "Camera System")
-		void Server_SetPitchAndYaw(float Yaw, float Pitch, FRotator SlerperRotation);
+	/** Server side ledge validation for a mantle the owning client predicted in its move */
+	bool MantleCheckFromMove();
+
+	/** Called by the movement component once the mantle root motion source has run out */
+	void MantleRootMotionFinished();
 
 	/** Character States */
 
@@ -273,6 +285,8 @@ public:
 	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
 	EALSMovementState GetMovementState() const { return MovementState; }
 
+	FVector GetLastRagdollVelocity() const { return LastRagdollVelocity; }
+
 	UFUNCTION(BlueprintGetter, Category = "ALS|Character States")
 	EALSMovementState GetPrevMovementState() const { return PrevMovementState; }
 
@@ -350,15 +364,6 @@ public:
 	UFUNCTION(BlueprintCallable, NetMulticast, Reliable, Category = "ALS|Character States")
 	void Multicast_PlayMontage(UAnimMontage* montage, float track);
 
-	/** Mantling*/
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
-	void Server_MantleStart(float MantleHeight, const FALSComponentAndTransform& MantleLedgeWS,
-	                        EALSMantleType MantleType);
-
-	UFUNCTION(BlueprintCallable, NetMulticast, Reliable, Category = "ALS|Character States")
-	void Multicast_MantleStart(float MantleHeight, const FALSComponentAndTransform& MantleLedgeWS,
-	                           EALSMantleType MantleType);
-
 	/** Ragdolling*/
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void ReplicatedRagdollStart();
@@ -386,24 +391,15 @@ public:
 	UFUNCTION(BlueprintSetter, Category = "ALS|Input")
 	void SetDesiredStance(EALSStance NewStance);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Input")
-	void Server_SetDesiredStance(EALSStance NewStance);
-
 	UFUNCTION(BlueprintCallable, Category = "ALS|Character States")
 	void SetDesiredGait(EALSGait NewGait);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
-	void Server_SetDesiredGait(EALSGait NewGait);
-
 	UFUNCTION(BlueprintGetter, Category = "ALS|Input")
 	EALSRotationMode GetDesiredRotationMode() const { return DesiredRotationMode; }
 
 	UFUNCTION(BlueprintSetter, Category = "ALS|Input")
 	void SetDesiredRotationMode(EALSRotationMode NewRotMode);
 
-	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "ALS|Character States")
-	void Server_SetDesiredRotationMode(EALSRotationMode NewRotMode);
-
 	UFUNCTION(BlueprintCallable, Category = "ALS|Input")
 	FVector GetPlayerMovementInput() const;
 
@@ -606,12 +602,12 @@ protected:
 	virtual bool MantleCheck(const FALSMantleTraceSettings& TraceSettings,
 	                         EDrawDebugTrace::Type DebugType = EDrawDebugTrace::Type::ForOneFrame);
 
-	UFUNCTION()
-	virtual void MantleUpdate(float BlendIn);
-
 	UFUNCTION()
 	virtual void MantleEnd();
 
+	/** Direction the mantle traces search along, input on the owning client and acceleration on the server */
+	FVector GetMantleDirection() const;
+
 	/** Utils */
 
 	float GetMappedSpeed() const;
@@ -682,6 +678,9 @@ protected:
 
 	UFUNCTION()
 	void OnRep_OverlayState(EALSOverlayState PrevOverlayState);
+
+	UFUNCTION()
+	void OnRep_ReplicatedMantle();
 	 
 	 // weapon stuff 
 
@@ -793,11 +792,6 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ALS|Mantle System")
 	float AcceptableVelocityWhileMantling = 10.0f;
 
-	/** Components */
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "ALS|Components")
-	UTimelineComponent* MantleTimeline = nullptr;
-
 	/** Essential Information */
 
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Essential Information")
@@ -832,17 +826,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Essential Information")
 	float EasedMaxAcceleration = 0.0f;
 
+	/** Acceleration, control rotation, gravity and slerper rotation, delta replicated as one block */
 	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
-	FVector ReplicatedCurrentAcceleration = FVector::ZeroVector;
-
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
-	FRotator ReplicatedControlRotation = FRotator::ZeroRotator;
-	
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
-		FVector ReplicatedGravityDirection = FVector::ZeroVector;
-
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "ALS|Essential Information")
-		FRotator ReplicatedQuatYawRotation = FRotator::ZeroRotator;
+	FALSReplicatedEssentials ReplicatedEssentials;
 
 		FVector LocalCorrectedRight; 
 		FVector LocalCorrectedForward;
@@ -908,6 +894,9 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = "ALS|Mantle System")
 	FTransform MantleAnimatedStartOffset = FTransform::Identity;
 
+	UPROPERTY(BlueprintReadOnly, Category = "ALS|Mantle System", ReplicatedUsing = OnRep_ReplicatedMantle)
+	FALSReplicatedMantle ReplicatedMantle;
+
 	/** Breakfall System */
 
 	/** If player hits to the ground with a specified amount of velocity, switch to breakfall state */
@@ -977,9 +966,10 @@ protected:
 	/* Smooth out aiming by interping control rotation*/
 	FRotator AimingRotation = FRotator::ZeroRotator;
 	FRotator QuatYawRotation = FRotator::ZeroRotator;
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "CameraSystem")
+	// Derived every tick from ReplicatedEssentials on all machines, so not replicated on their own
+	UPROPERTY(BlueprintReadOnly, Category = "CameraSystem")
 	float DeltaPitch = 0.f;
-	UPROPERTY(BlueprintReadOnly, Replicated, Category = "CameraSystem")
+	UPROPERTY(BlueprintReadOnly, Category = "CameraSystem")
 	float DeltaYaw = 0.f;
 
 	void UpdateDeltaPitch();
@@ -7,8 +7,59 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Library/ALSCharacterEnumLibrary.h"
+#include "WorldCollision.h"
 #include "ALSCharacterMovementComponent.generated.h"
 
+class UALSRotatingBaseComponent;
+
+struct FALSRootMotionSource_Mantle;
+
+DECLARE_STATS_GROUP(TEXT("ALSMovement"), STATGROUP_ALSMovement, STATCAT_Advanced);
+
+// Last FindFloor result and everything it depended on, reused while none of it changes
+struct FALSFloorCache
+{
+	bool bValid = false;
+
+	// Floor component and its transform when the result was computed, the capsule is stored relative to it
+	TWeakObjectPtr<const UPrimitiveComponent> Base;
+	FTransform BaseTransform = FTransform::Identity;
+	FVector CapsuleLocationBS = FVector::ZeroVector;
+
+	FQuat CapsuleRotation = FQuat::Identity;
+	float CapsuleRadius = 0.0f;
+	float CapsuleHalfHeight = 0.0f;
+	FIntVector GravityKey = FIntVector::ZeroValue;
+	bool bMovingOnGround = false;
+	float Time = 0.0f;
+
+	FFindFloorResult Result;
+};
+
+// Floor sweep issued at the end of the previous frame from where the capsule was expected to be this frame
+struct FALSAsyncFloorProbe
+{
+	FTraceHandle Handle;
+	FVector Start = FVector::ZeroVector;
+	FVector Down = FVector::DownVector;
+	float Distance = 0.0f;
+	FCollisionShape Shape;
+};
+
+// Both ledge directions of a GetLedgeMove call that had no result yet, side and down sweeps issued together
+struct FALSAsyncLedgeProbe
+{
+	bool bRequested = false;
+	FVector OldLocation = FVector::ZeroVector;
+	FVector Delta = FVector::ZeroVector;
+	FVector GravDir = FVector::DownVector;
+
+	FVector SideSteps[2];
+	FTraceHandle SideHandles[2];
+	FTraceHandle DownHandles[2];
+};
+
 /**
  * Authoritative networked Character Movement
  */
@@ -27,9 +78,76 @@ class ALSV4_CPP_API UALSCharacterMovementComponent : public UCharacterMovementCo
 		virtual uint8 GetCompressedFlags() const override;
 		virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel,
 		                        class FNetworkPredictionData_Client_Character& ClientData) override;
+		virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+		virtual void PrepMoveFor(ACharacter* Character) override;
+		virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
 
 		// Walk Speed Update
 		uint8 bSavedRequestMovementSettingsChange : 1;
+
+		// Client predicted a mantle start in this move
+		uint8 bSavedWantsToMantle : 1;
+
+		// Gravity the move was simulated with, restored before replaying it
+		FVector SavedGravityDirection;
+		float SavedGravityScale;
+
+		// Fixed timestep remainder before the move, and the force carried with it, so a replay substeps it the same way
+		float SavedFixedStepTime;
+		FVector SavedFixedStepForceTime;
+
+		// Wind channel smoothing state before the move, so a replay pushes with the same wind
+		FVector SavedSmoothedWindForce;
+
+		// Camera aim of the owning client, sent with the move instead of a per-tick RPC
+		FRotator SavedCameraRotation;
+		FRotator SavedCameraPollRotation;
+
+		// Desired states the client simulated this move with, and the walk speed they resolved to
+		EALSGait SavedDesiredGait;
+		EALSStance SavedDesiredStance;
+		EALSRotationMode SavedDesiredRotationMode;
+		float SavedMaxWalkSpeed;
+	};
+
+	// Packed move data carrying the gravity frame alongside the engine move fields
+	class FALSCharacterNetworkMoveData : public FCharacterNetworkMoveData
+	{
+	public:
+
+		typedef FCharacterNetworkMoveData Super;
+
+		FALSCharacterNetworkMoveData();
+
+		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+
+		FVector_NetQuantizeNormal GravityDirection;
+		float GravityScale;
+
+		// Aim is only written when it moved past p.NetMoveAimSendThreshold or the refresh interval ran out
+		uint8 bHasAim;
+		FRotator CameraRotation;
+		FRotator CameraPollRotation;
+
+		uint8 DesiredGait;
+		uint8 DesiredStance;
+		uint8 DesiredRotationMode;
+
+		// Fixed timestep remainder the client started the move with, so the server runs the same substeps
+		float FixedStepTime;
+
+		// Force times time the client carried over with that remainder
+		FVector FixedStepForceTime;
+	};
+
+	class FALSCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+	{
+	public:
+
+		FALSCharacterNetworkMoveDataContainer();
+
+		FALSCharacterNetworkMoveData MoveData[3];
 	};
 
 	class FNetworkPredictionData_Client_My : public FNetworkPredictionData_Client_Character
@@ -46,6 +164,8 @@ public:
 
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
 	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
 	virtual void OnMovementUpdated(float DeltaTime, const FVector& OldLocation, const FVector& OldVelocity) override;
 
 
@@ -54,14 +174,40 @@ public:
 
 	float MyNewMaxWalkSpeed = 0;
 
-	// Set Max Walking Speed (Called from the owning client)
+	// Set Max Walking Speed (Called on the owning client and on the server from the move's desired states)
 	UFUNCTION(BlueprintCallable, Category = "Movement Settings")
 	void SetMaxWalkingSpeed(float NewMaxWalkSpeed);
 
-	UFUNCTION(Reliable, Server)
-	void Server_SetMaxWalkingSpeed(float NewMaxWalkSpeed);
+	// True while in the zero gravity custom movement mode
+	bool IsInZeroGravity() const;
+
+	// How fast the capsule turns towards the full control rotation in zero gravity, in degrees per second
+	UPROPERTY(Category = "Character Movement: Zero Gravity", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0", UIMin = "0"))
+		float ZeroGravityRotationRate = 180.0f;
+
+	// Apply gravity carried by a client move without the zero-G state transitions of SetGravityDirection
+	void ApplyMoveGravity(const FVector& NewGravityDirection, float NewGravityScale);
+
+	FALSCharacterNetworkMoveDataContainer ALSNetworkMoveDataContainer;
+
+	// Returns true when the aim differs enough from the last one sent to be worth putting in the next move (Client only)
+	bool ShouldSendMoveAim(const FRotator& CameraRotation, const FRotator& CameraPollRotation);
+
+	FRotator LastSentCameraRotation;
+	FRotator LastSentCameraPollRotation;
+	float LastSentAimTime = -1.f;
+
+	// Mantle System
+	// Set when the owning client starts a mantle, the server validates the ledge itself when the move carries it
+	uint8 bWantsToMantle = 0;
 
-	bool ForceZeroG = false;
+	uint16 MantleRootMotionSourceID = 0;
+
+	// Start driving the mantle from the root motion source (Called on the owning client and the server)
+	void ApplyMantleRootMotion(TSharedPtr<FALSRootMotionSource_Mantle> MantleSource);
+
+	// Drop the mantle root motion source without finishing the mantle, e.g. when going ragdoll
+	void StopMantleRootMotion();
 
 
 	//GRAVITY OVERRIDES::
@@ -75,6 +221,7 @@ public:
 	virtual FVector GetFallingLateralAcceleration(float DeltaTime) override;
 	virtual FVector NewFallVelocity(const FVector& InitialVelocity, const FVector& Gravity, float DeltaTime) const override;
 	virtual void UpdateBasedMovement(float DeltaSeconds) override;
+	virtual void SaveBaseLocation() override;
 	virtual bool DoJump(bool bReplayingMoves) override;
 	virtual FVector GetImpartedMovementBaseVelocity() const override;
 	virtual void JumpOff(AActor* MovementBaseActor) override;
@@ -107,10 +254,49 @@ public:
 	virtual void ApplyAccumulatedForces(float DeltaSeconds) override;
 	virtual void AddForce(FVector Force) override;
 
+	// Force the channel pushes the capsule with at its current location and velocity, before MassForceResistance
+	FVector GetChannelForce(EALSForceChannel Channel) const;
+
 	UFUNCTION(Category = "Pawn|Components|CharacterMovement", BlueprintCallable)
 		virtual void SetGravityDirection(FVector NewGravityDirection);
 
 	void GravityControlRotation(FRotator Rotation);
+
+	// Take gravity from the world's UALSGravityFieldSubsystem wherever one of its sources covers the capsule
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
+		bool bUseGravityField = true;
+
+	// True when gravity is world down and the capsule is upright, so the world gravity frame paths can be used
+	bool UsesWorldGravityFrame() const;
+
+	// Run movement in whole substeps of FixedTimestep and interpolate the mesh between the last two of them
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite)
+		bool bUseFixedTimestep = false;
+
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.001", UIMin = "0.001", EditCondition = "bUseFixedTimestep"))
+		float FixedTimestep = 1.0f / 60.0f;
+
+	// Substeps run at most per update, time beyond them is dropped
+	UPROPERTY(Category = "Character Movement (General Settings)", EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1", UIMin = "1", EditCondition = "bUseFixedTimestep"))
+		int32 MaxFixedSubsteps = 8;
+
+	// Server side AI only: floor and ledge sweeps go through the world's async trace API and are used the next frame
+	UPROPERTY(Category = "Character Movement: AI", EditAnywhere, BlueprintReadWrite)
+		bool bUseAsyncMovementQueries = false;
+
+	bool UsesAsyncMovementQueries() const;
+
+	// Issue the queued async floor and ledge sweeps within the budget, returns how many were issued (Called by UALSMovementQuerySubsystem)
+	int32 IssueAsyncMovementQueries(int32 MaxSweeps);
+
+	// Movement LOD a simulated proxy currently runs SimulateMovement at
+	EALSMovementLOD GetMovementLOD() const { return MovementLOD; }
+
+#if !UE_BUILD_SHIPPING
+	// Time whole movement steps through both gravity frames from the current state, restored afterwards, and log them
+	void BenchmarkGravityFrames(int32 Iterations);
+#endif
+
 protected:
 	// Return the normalized direction of the current gravity.
 	// @note Could return zero gravity.
@@ -127,9 +313,19 @@ protected:
 
 	// Begin UCharacterMovementComponent overrides
 	virtual void PhysFlying(float deltaTime, int32 Iterations) override;
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+
+	// Inertial 6DOF movement: thrust from input, no floor, step up or walkability checks, capsule turned with the control rotation
+	void PhysZeroGravity(float deltaTime, int32 Iterations);
 	virtual float BoostAirControl(float DeltaTime, float TickAirControl, const FVector& FallAcceleration) override;
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	virtual void PerformMovement(float DeltaTime) override;
+
+	// One movement update of DeltaTime, what PerformMovement runs once per substep in fixed timestep mode
+	void PerformMovementStep(float DeltaTime);
+
+	// Offset the mesh to where the capsule was between the last two substeps
+	void UpdateFixedStepVisuals();
 	virtual void HandleImpact(const FHitResult& Hit, float TimeSlice = 0.f, const FVector& MoveDelta = FVector::ZeroVector) override;
 	virtual void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
 
@@ -162,7 +358,103 @@ protected:
 	FVector GetCapsuleAxisX() const;
 	FVector GetCapsuleAxisZ() const;
 	FVector GetSafeNormalPrecise(const FVector& V);
+	// Reuse the cached floor for this query if nothing it depends on has changed
+	bool GetCachedFloor(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult) const;
+
+	void CacheFloor(const FVector& CapsuleLocation, const FFindFloorResult& FloorResult) const;
+
+	FIntVector GetFloorCacheGravityKey() const;
+
+	mutable FALSFloorCache FloorCache;
+
+	// Last frame's async floor sweep in place of ComputeFloorDist's first sweep, false if it doesn't apply here
+	bool ConsumeAsyncFloorProbe(const FVector& CapsuleLocation, const FVector& CapsuleDown, const FCollisionShape& CapsuleShape, float TraceDist, FHitResult& OutHit) const;
+
+	// Last frame's async ledge sweeps for this ledge, false if there are none
+	bool ConsumeAsyncLedgeProbe(const FVector& OldLocation, const FVector& Delta, const FVector& GravDir, FVector& OutSideStep) const;
+
+	mutable FALSAsyncFloorProbe AsyncFloorProbe;
+
+	mutable FALSAsyncLedgeProbe AsyncLedgeProbe;
+
+	// Re-evaluate the proxy's movement LOD when due, returns whether this frame runs the full simulation
+	bool UpdateSimulatedMovementLOD(float DeltaTime);
+
+	// Tier from the distance to the closest local view, one further when the mesh wasn't rendered lately
+	EALSMovementLOD ComputeMovementLOD() const;
+
+	// Fixed timestep time not yet simulated, and the force integrated over it
+	float FixedStepTime = 0.0f;
+	FVector FixedStepForceTime = FVector::ZeroVector;
+
+	// Capsule transform before and after the last substep
+	FTransform FixedStepPrevTransform = FTransform::Identity;
+	FTransform FixedStepCurrTransform = FTransform::Identity;
+
+	EALSMovementLOD MovementLOD = EALSMovementLOD::Full;
+	float NextMovementLODTime = 0.0f;
+	float MovementLODAccumulatedTime = 0.0f;
+
+	template <typename GravityFrame>
 	bool IsWithinEdgeToleranceNew(const FVector& CapsuleLocation, const FVector& CapsuleDown, const FVector& TestImpactPoint, const float CapsuleRadius) const;
+
+	// Movement paths specialized on a gravity frame policy from ALSGravityFrame.h, the overrides pick one per call
+	template <typename GravityFrame>
+	void PhysWalkingImpl(float deltaTime, int32 Iterations);
+	template <typename GravityFrame>
+	void PhysFallingImpl(float deltaTime, int32 Iterations);
+
+	// Displacement after Time under constant acceleration, capped at terminal velocity along gravity like NewFallVelocity
+	FVector ComputeFallingMove(const FVector& InitialVelocity, const FVector& FallAcceleration, const FVector& GravityDir, float Time, FVector& OutVelocity) const;
+
+	// Rotating base declared by the base's owner, nullptr for any other base
+	UALSRotatingBaseComponent* GetRotatingBase(const UPrimitiveComponent* MovementBase) const;
+
+	// Follow a rotating base by its spin angle since the last update, without reading back base transforms
+	void UpdateRotatingBasedMovement(UALSRotatingBaseComponent* RotatingBase);
+
+	// Take gravity from the spin of the rotating base we stand on or last fell off
+	void UpdateCentrifugalGravity();
+
+	// Sample the gravity field at the capsule, entering or leaving zero gravity where it has none
+	void UpdateFieldGravity();
+
+	// Give back the direction and scale the field took over from once no source covers the capsule
+	void RestoreExternalGravity();
+
+	// Gravity of a move as a direction and an acceleration, converted to the direction and scale GetGravity() works with
+	void ApplyMoveGravityAcceleration(const FVector& Direction, float Acceleration);
+
+	mutable TWeakObjectPtr<const AActor> CachedRotatingBaseOwner;
+	mutable TWeakObjectPtr<UALSRotatingBaseComponent> CachedRotatingBase;
+
+	// Spin angle of the rotating base at the last SaveBaseLocation
+	TWeakObjectPtr<UALSRotatingBaseComponent> OldRotatingBase;
+	float OldRotatingBaseAngle = 0.0f;
+
+	TWeakObjectPtr<UALSRotatingBaseComponent> CentrifugalGravityBase;
+
+	// Whether the gravity field is driving gravity, and the gravity set from outside before it took over
+	bool bFieldGravityActive = false;
+	FVector ExternalGravityDirection = FVector::DownVector;
+	float ExternalGravityScale = 1.0f;
+
+	// Add every force channel to the pending force, evaluated inside the move so server and owning client agree
+	void ApplyForceChannels(float DeltaTime);
+
+	// Wind channel force, eased towards the flow field sample every move
+	FVector SmoothedWindForce = FVector::ZeroVector;
+
+	// External force of this update, applied by PhysFalling together with gravity instead of up front
+	FVector FallingExternalAcceleration = FVector::ZeroVector;
+	template <typename GravityFrame>
+	void FindFloorImpl(const FVector& CapsuleLocation, FFindFloorResult& OutFloorResult, bool bZeroDelta, const FHitResult* DownwardSweepResult) const;
+	template <typename GravityFrame>
+	void ComputeFloorDistImpl(const FVector& CapsuleLocation, float LineDistance, float SweepDistance, FFindFloorResult& OutFloorResult, float SweepRadius, const FHitResult* DownwardSweepResult) const;
+	template <typename GravityFrame>
+	bool StepUpImpl(const FVector& GravDir, const FVector& Delta, const FHitResult& Hit, FStepDownResult* OutStepDownResult);
+	template <typename GravityFrame>
+	void MaintainHorizontalGroundVelocityImpl();
 	bool bFallingRemovesSpeedZ;
 	bool bIgnoreBaseRollMove;
 
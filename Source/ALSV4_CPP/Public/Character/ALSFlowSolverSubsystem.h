@@ -0,0 +1,112 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DependencyFix/Public/RoomDataHelper.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSFlowSolverSubsystem.generated.h"
+
+class AALSRoomFlowReplicator;
+
+/** What a room's flow is blended from: the air currents the room's data helper blends into its compressed forces */
+struct FALSFlowSolveInput
+{
+	TWeakObjectPtr<ARoomDataHelper> DataHelper;
+
+	TArray<FFloatBool> AirCurrentData;
+
+	// Grid the helper's blend is laid out on, one force per point, X fastest
+	FVector Origin = FVector::ZeroVector;
+
+	FVector CellSize = FVector(100.0f);
+
+	FIntVector Dimensions = FIntVector::ZeroValue;
+};
+
+/** Solve state of one room. The data helper blends into the back buffer while the front one stays published */
+struct FALSFlowRoomState
+{
+	FALSFlowSolveInput Input;
+
+	// Input the back buffer is being blended from
+	FALSFlowSolveInput SolvingInput;
+
+	FCompressedForceArray Buffers[2];
+
+	int32 FrontBuffer = 0;
+
+	// A blend was started and its result hasn't been published yet
+	bool bSolving = false;
+
+	// The blend finished and wrote the back buffer
+	bool bSolved = false;
+
+	bool bInputChanged = false;
+
+	bool bHasResult = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FALSOnFlowPublished, int32 /*RoomID*/, const FCompressedForceArray& /*CompressedForces*/);
+
+/**
+ * Solves the air flow of every room on the server with the room data helper's own asynchronous blend, so no client
+ * sits in the loop, and publishes the finished results at a fixed cadence: decoded onto the room's grid for the wind
+ * field and the room's delta replication, and to OnFlowPublished listeners.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSFlowSolverSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Set what the room's flow is solved from, it is solved again at the next publish (Server only)
+	void SetRoomInput(int32 RoomID, const FALSFlowSolveInput& Input);
+
+	// Publish a room's flow grid, Forces holds Dimensions.X * Dimensions.Y * Dimensions.Z points, X fastest (Server only)
+	void SetRoomFlowGrid(int32 RoomID, const FVector& Origin, const FVector& CellSize, const FIntVector& Dimensions,
+	                     TArray<FVector> Forces);
+
+	void RemoveRoom(int32 RoomID);
+
+	// Copy of the last published flow of the room, false if it has none yet. A copy, since the next publish swaps
+	// the buffers and the following blend overwrites the one that was published
+	bool GetPublishedFlow(int32 RoomID, FCompressedForceArray& OutCompressedForces) const;
+
+	static UALSFlowSolverSubsystem* Get(const UObject* WorldContextObject);
+
+	// Forces of a blend at every point of a grid of Dimensions, false if the blend doesn't cover the grid
+	static bool DecodeFlow(const FCompressedForceArray& CompressedForces, const FIntVector& Dimensions,
+	                       TArray<FVector>& OutForces);
+
+	FALSOnFlowPublished OnFlowPublished;
+
+protected:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void Publish();
+
+	// Result of a data helper's blend, arrives on the game thread
+	UFUNCTION()
+	void OnFlowBlended(const FCompressedForceArray& CompressedForces, ARoomDataHelper* DataHelper);
+
+	TMap<int32, FALSFlowRoomState> Rooms;
+
+	// Replicates each room's published flow to the clients in or near it
+	UPROPERTY()
+	TMap<int32, AALSRoomFlowReplicator*> Replicators;
+
+	float TimeSinceLastPublish = 0.0f;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,96 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Library/ALSCharacterEnumLibrary.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSGravityFieldSubsystem.generated.h"
+
+class UALSGravitySourceComponent;
+class USplineComponent;
+
+/** World space snapshot of a gravity source, taken when it registers or updates */
+struct FALSGravitySource
+{
+	EALSGravitySourceShape Shape = EALSGravitySourceShape::Point;
+
+	FTransform Transform = FTransform::Identity;
+
+	FVector Axis = FVector::UpVector;
+
+	float Strength = 0.0f;
+
+	int32 Priority = 0;
+
+	float FalloffDistance = 1.0f;
+
+	float Radius = 0.0f;
+
+	float HalfHeight = 0.0f;
+
+	FVector BoxExtent = FVector::ZeroVector;
+
+	bool bInvert = false;
+
+	TWeakObjectPtr<USplineComponent> Spline;
+
+	FBox Bounds = FBox(ForceInit);
+};
+
+/**
+ * Gravity sources of a world in a uniform grid, so movement components sample the gravity at their location by looking
+ * at the few sources overlapping one cell. Sources change only when they register, update or go away, which makes the
+ * field the same on the server and the predicting client.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSGravityFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void RegisterSource(UALSGravitySourceComponent* Source);
+
+	void UnregisterSource(UALSGravitySourceComponent* Source);
+
+	// Gravity acceleration at Location, false when no source covers it
+	bool SampleGravity(const FVector& Location, FVector& OutGravity);
+
+	// SampleGravity for many locations, consecutive locations in the same cell share the cell lookup
+	void SampleGravityBatch(TArrayView<const FVector> Locations, TArrayView<FVector> OutGravity, TArrayView<bool> OutCovered);
+
+	bool HasSources() const { return SourceComponents.Num() > 0; }
+
+	static UALSGravityFieldSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	void RebuildGrid();
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	bool SampleSources(const TArray<int32>* CellSources, const FVector& Location, FVector& OutGravity) const;
+
+	// Acceleration of one source at Location, false when it doesn't reach it
+	bool SampleSource(const FALSGravitySource& Source, const FVector& Location, FVector& OutGravity) const;
+
+	TArray<TWeakObjectPtr<UALSGravitySourceComponent>> SourceComponents;
+
+	TArray<FALSGravitySource> Sources;
+
+	// Source indices overlapping each cell
+	TMap<FIntVector, TArray<int32>> Grid;
+
+	// Sources too large to put in the grid, checked everywhere
+	TArray<int32> UnboundedSources;
+
+	float CellSize = 2000.0f;
+
+	bool bGridDirty = false;
+};
@@ -0,0 +1,69 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Gravity frame policies the movement component's floor, walking and falling code is templated on.
+// Every axis passed to them is the capsule up/down axis or the gravity direction.
+
+// Gravity is world down and the capsule is upright, so every axis is +/-Z and the vector math reduces to
+// picking components.
+struct FALSWorldGravityFrame
+{
+	static constexpr bool bWorldAligned = true;
+
+	static FORCEINLINE FVector GetCapsuleUp(const FQuat& CapsuleRotation)
+	{
+		return FVector::UpVector;
+	}
+
+	static FORCEINLINE float DotAxis(const FVector& V, const FVector& Axis)
+	{
+		return V.Z * Axis.Z;
+	}
+
+	static FORCEINLINE FVector ProjectOntoAxis(const FVector& V, const FVector& Axis)
+	{
+		return FVector(0.0f, 0.0f, V.Z);
+	}
+
+	static FORCEINLINE FVector ProjectOntoPlane(const FVector& V, const FVector& Axis)
+	{
+		return FVector(V.X, V.Y, 0.0f);
+	}
+};
+
+// Arbitrary gravity direction and capsule orientation
+struct FALSCustomGravityFrame
+{
+	static constexpr bool bWorldAligned = false;
+
+	static FORCEINLINE FVector GetCapsuleUp(const FQuat& CapsuleRotation)
+	{
+		// Fast simplification of FQuat::RotateVector() with FVector(0,0,1).
+		const FVector QuatVector(CapsuleRotation.X, CapsuleRotation.Y, CapsuleRotation.Z);
+
+		return FVector(CapsuleRotation.Y * CapsuleRotation.W * 2.0f, CapsuleRotation.X * CapsuleRotation.W * -2.0f,
+		               FMath::Square(CapsuleRotation.W) - QuatVector.SizeSquared()) +
+			QuatVector * (CapsuleRotation.Z * 2.0f);
+	}
+
+	static FORCEINLINE float DotAxis(const FVector& V, const FVector& Axis)
+	{
+		return V | Axis;
+	}
+
+	static FORCEINLINE FVector ProjectOntoAxis(const FVector& V, const FVector& Axis)
+	{
+		return Axis * (V | Axis);
+	}
+
+	static FORCEINLINE FVector ProjectOntoPlane(const FVector& V, const FVector& Axis)
+	{
+		return FVector::VectorPlaneProject(V, Axis);
+	}
+};
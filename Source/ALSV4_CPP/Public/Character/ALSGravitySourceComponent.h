@@ -0,0 +1,70 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "Library/ALSCharacterEnumLibrary.h"
+#include "ALSGravitySourceComponent.generated.h"
+
+class USplineComponent;
+
+/**
+ * Analytic gravity source registered with the world's UALSGravityFieldSubsystem. Full strength within the shape,
+ * fading out linearly over FalloffDistance beyond it. The highest priority sources covering a location decide its gravity.
+ */
+UCLASS(ClassGroup = (ALS), meta = (BlueprintSpawnableComponent))
+class ALSV4_CPP_API UALSGravitySourceComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UALSGravitySourceComponent();
+
+	virtual void OnRegister() override;
+
+	virtual void OnUnregister() override;
+
+	/** Pick up a changed transform or shape. Sources are treated as static between calls */
+	UFUNCTION(BlueprintCallable, Category = "ALS|Gravity Source")
+	void UpdateSource();
+
+	/** Point pulls towards the component's location, cylinder towards its up axis, box along its down vector and
+	 * spline along the down vector of the closest spline point */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source")
+	EALSGravitySourceShape Shape = EALSGravitySourceShape::Point;
+
+	/** Acceleration at full strength, 0 makes a zero gravity region */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source", meta = (ClampMin = "0", UIMin = "0"))
+	float Strength = 980.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source")
+	int32 Priority = 0;
+
+	/** Distance beyond the shape over which the strength fades to nothing */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source", meta = (ClampMin = "1", UIMin = "1"))
+	float FalloffDistance = 1000.0f;
+
+	/** Point: planet radius. Cylinder: radius around the axis. Spline: distance from the spline kept at full strength */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source", meta = (ClampMin = "0", UIMin = "0"))
+	float Radius = 1000.0f;
+
+	/** Cylinder: half length along the axis */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source", meta = (ClampMin = "0", UIMin = "0"))
+	float HalfHeight = 1000.0f;
+
+	/** Box: half size in the component's space */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source")
+	FVector BoxExtent = FVector(500.0f);
+
+	/** Push away from the point or axis instead, e.g. for the inside of a rotating ring */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Gravity Source")
+	bool bInvert = false;
+
+	/** Spline: first spline component of the owner when not set */
+	UPROPERTY(BlueprintReadWrite, Category = "ALS|Gravity Source")
+	USplineComponent* Spline = nullptr;
+};
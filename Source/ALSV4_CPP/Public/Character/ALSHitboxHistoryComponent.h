@@ -0,0 +1,100 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ALSHitboxHistoryComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+DECLARE_STATS_GROUP(TEXT("ALSHitbox"), STATGROUP_ALSHitbox, STATCAT_Advanced);
+
+/** Capsule approximation of one physics body, relative to the bone it is attached to */
+struct FALSHitboxCapsule
+{
+	int32 BoneIndex = INDEX_NONE;
+
+	FTransform LocalTransform = FTransform::Identity;
+
+	float Radius = 0.0f;
+
+	float HalfLength = 0.0f;
+};
+
+/** Hitbox capsule segments in world space at one recorded time */
+struct FALSHitboxSnapshot
+{
+	float Time = -1.0f;
+
+	FBox Bounds = FBox(ForceInit);
+
+	TArray<FVector> SegmentStarts;
+
+	TArray<FVector> SegmentEnds;
+};
+
+/**
+ * Server side history of a character's hitboxes, used to rewind it to the time a client fired at it.
+ * The bodies of the mesh's physics asset are reduced to capsules and recorded at a fixed rate into a ring buffer.
+ */
+UCLASS(ClassGroup = (ALS), meta = (BlueprintSpawnableComponent))
+class ALSV4_CPP_API UALSHitboxHistoryComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UALSHitboxHistoryComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
+	                           FActorComponentTickFunction* ThisTickFunction) override;
+
+	/**
+	 * Test a shot segment against the hitboxes as they were at the given server time.
+	 * Shots claimed further back than the shooter's latency plus RewindSlack are rejected, times in the future use now.
+	 */
+	bool ValidateShot(const FVector& Start, const FVector& End, float Time, float ShooterLatency) const;
+
+	/** Oldest server time a shot can still be rewound to, -1 if nothing has been recorded yet */
+	float GetOldestRecordedTime() const;
+
+	/** Record the current hitbox pose into the ring buffer */
+	void RecordSnapshot();
+
+	int32 GetNumHitboxes() const { return Hitboxes.Num(); }
+
+	/** Number of snapshots kept. Together with the record rate this bounds how far back a shot can be rewound */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Hitbox History", meta = (ClampMin = "2", UIMin = "2"))
+	int32 HistoryDepth = 32;
+
+	/** Snapshots recorded per second */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Hitbox History", meta = (ClampMin = "1.0", UIMin = "1.0"))
+	float RecordRate = 30.0f;
+
+	/** Seconds a shot may be rewound beyond the shooter's latency, covering interpolation delay and jitter */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Hitbox History", meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float RewindSlack = 0.15f;
+
+	/** Extra radius allowed around every capsule to absorb interpolation and quantization error */
+	UPROPERTY(EditDefaultsOnly, Category = "ALS|Hitbox History", meta = (ClampMin = "0.0", UIMin = "0.0"))
+	float HitLeeway = 10.0f;
+
+protected:
+	void BuildHitboxes();
+
+	UPROPERTY()
+	USkeletalMeshComponent* Mesh = nullptr;
+
+	TArray<FALSHitboxCapsule> Hitboxes;
+
+	TArray<FALSHitboxSnapshot> Snapshots;
+
+	int32 NewestSnapshot = INDEX_NONE;
+
+	int32 NumSnapshots = 0;
+};
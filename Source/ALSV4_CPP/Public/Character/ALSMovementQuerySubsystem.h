@@ -0,0 +1,47 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSMovementQuerySubsystem.generated.h"
+
+class UALSCharacterMovementComponent;
+
+/**
+ * Issues the floor and ledge sweeps AI movement components queued during the frame through the world's async trace
+ * API once all actors ticked, so their results are ready the next frame. At most ALS.AsyncMovementQueries.MaxSweeps
+ * sweeps are issued per frame, components over the budget sweep synchronously until theirs are issued. GetLedgeMove
+ * holds a character at the ledge for the one frame its issued ledge sweeps take to come back.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSMovementQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Issue the component's queries at the end of this frame
+	void QueueQueries(UALSCharacterMovementComponent* MovementComponent);
+
+	static UALSMovementQuerySubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	TArray<TWeakObjectPtr<UALSCharacterMovementComponent>> QueuedComponents;
+
+	// Queue index issuing starts from, rotated so the same components aren't always the ones over budget
+	int32 FirstQueued = 0;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,170 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+
+#include "ALSReplicationGraph.generated.h"
+
+class UALSRoomStreamingSubsystem;
+
+/**
+ * Sorts actors into one list per room and gathers, for each connection, the lists of the rooms its view target is
+ * in, is predicted to enter and can see through a portal. Actors outside every room are kept apart and gathered per
+ * connection by distance, see UALSReplicationGraphNode_Unroomed_ForConnection.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSReplicationGraphNode_Rooms : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UALSReplicationGraphNode_Rooms();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void PrepareForReplication() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	// Room of characters, flow replicators and whatever they own, false for actors nobody in that chain holds
+	static bool GetOwnerRoom(const AActor* Actor, int32& OutRoomID);
+
+	// Whether the room lists track the actor, i.e. the graph routed it here
+	bool IsTracked(const AActor* Actor) const { return TrackedActors.Contains(const_cast<AActor*>(Actor)); }
+
+	// Whether a connection with these viewers gets the actor through the room lists
+	bool IsGatheredFor(const FNetViewerArray& Viewers, const AActor* Actor) const;
+
+	// Actors outside every room, left to each connection to cull by distance
+	const TArray<FActorRepListType>& GetUnroomedActors() const { return UnroomedActors; }
+
+protected:
+	struct FTrackedActor
+	{
+		explicit FTrackedActor(const FNewReplicatedActorInfo& InActorInfo) : ActorInfo(InActorInfo)
+		{
+		}
+
+		FNewReplicatedActorInfo ActorInfo;
+
+		int32 RoomID = INDEX_NONE;
+
+		// Room of the actor's level, looked up once when the actor is added
+		int32 LevelRoomID = INDEX_NONE;
+
+		// Whether the actor can change rooms, the others are placed once
+		bool bDynamic = false;
+
+		// Whether the actor moves on its own, so is placed by its location when nobody holds it
+		bool bMovable = false;
+	};
+
+	// Rooms the viewers see into, false when one of them sees every room
+	bool GatherRoomIDs(const FNetViewerArray& Viewers, TArray<int32, TInlineAllocator<16>>& OutRoomIDs) const;
+
+	// Room the actor is in: its owner's, else the room whose bounds it is in if it moves, else its level's room
+	int32 GetActorRoom(const FTrackedActor& Tracked) const;
+
+	UReplicationGraphNode_ActorList* GetRoomNode(int32 RoomID);
+
+	void AddToRoom(int32 RoomID, const FNewReplicatedActorInfo& ActorInfo);
+
+	void RemoveFromRoom(int32 RoomID, const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound);
+
+	TMap<FActorRepListType, FTrackedActor> TrackedActors;
+
+	TArray<FActorRepListType> UnroomedActors;
+
+	UPROPERTY()
+	TMap<int32, UReplicationGraphNode_ActorList*> RoomNodes;
+
+	TWeakObjectPtr<UALSRoomStreamingSubsystem> RoomStreaming;
+};
+
+/** What a connection always gets regardless of rooms: its controller, its view target and whatever they own */
+UCLASS()
+class ALSV4_CPP_API UALSReplicationGraphNode_AlwaysRelevant_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+};
+
+/**
+ * Actors outside every room that are within their NetCullDistanceSquared of one of the connection's viewers. Their
+ * class cull distance can't do it, characters have none since rooms decide who gets them
+ */
+UCLASS()
+class ALSV4_CPP_API UALSReplicationGraphNode_Unroomed_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override
+	{
+	}
+
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override
+	{
+		return false;
+	}
+
+	virtual void NotifyResetAllNetworkActors() override
+	{
+	}
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	UPROPERTY()
+	UALSReplicationGraphNode_Rooms* RoomsNode = nullptr;
+
+protected:
+	FActorRepListRefView ReplicationActorList;
+};
+
+/**
+ * Replication graph relevancy by room instead of by distance. Enabled per project through the net driver, e.g.
+ * [/Script/OnlineSubsystemUtils.IpNetDriver] ReplicationDriverClassName="/Script/ALSV4_CPP.ALSReplicationGraph"
+ */
+UCLASS(Transient)
+class ALSV4_CPP_API UALSReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void ResetGameWorldState() override;
+
+	virtual void InitGlobalActorClassSettings() override;
+
+	virtual void InitGlobalGraphNodes() override;
+
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+	                                         FGlobalActorReplicationInfo& GlobalInfo) override;
+
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	const UALSReplicationGraphNode_Rooms* GetRoomsNode() const { return RoomsNode; }
+
+	// Characters and room flow, placed by room even when they are bAlwaysRelevant for the default net driver
+	static bool IsRoomRelevant(const AActor* Actor);
+
+protected:
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode = nullptr;
+
+	UPROPERTY()
+	UALSReplicationGraphNode_Rooms* RoomsNode = nullptr;
+};
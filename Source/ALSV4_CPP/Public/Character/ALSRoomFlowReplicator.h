@@ -0,0 +1,127 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Engine/NetSerialization.h"
+#include "ALSRoomFlowReplicator.generated.h"
+
+class AALSRoomFlowReplicator;
+
+/** Flow of up to 64 consecutive grid points, 8 bits per axis */
+USTRUCT()
+struct FALSFlowChunk : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 ChunkIndex = 0;
+
+	/** X, Y and Z of every point, scaled to the replicator's quantization range */
+	UPROPERTY()
+	TArray<int8> Cells;
+
+	void PostReplicatedAdd(const struct FALSFlowChunkArray& InArraySerializer);
+
+	void PostReplicatedChange(const struct FALSFlowChunkArray& InArraySerializer);
+};
+
+USTRUCT()
+struct FALSFlowChunkArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FALSFlowChunk> Chunks;
+
+	UPROPERTY(NotReplicated)
+	AALSRoomFlowReplicator* Owner = nullptr;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FALSFlowChunk, FALSFlowChunkArray>(Chunks, DeltaParms, *this);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FALSFlowChunkArray> : public TStructOpsTypeTraitsBase2<FALSFlowChunkArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Replicates the solved flow of one room. Only chunks whose quantized values changed since the last update are sent,
+ * and only to clients that see the room: with UALSReplicationGraph the room lists decide, as for everything else in
+ * the room.
+ */
+UCLASS(NotPlaceable, Transient)
+class ALSV4_CPP_API AALSRoomFlowReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AALSRoomFlowReplicator();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PostInitializeComponents() override;
+
+	virtual void PostNetReceive() override;
+
+	virtual void Destroyed() override;
+
+	/**
+	 * Fallback for net drivers without UALSReplicationGraph, which never asks: the room the viewer is in and the one
+	 * it is predicted to enter
+	 */
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	/** Quantize the room's flow and mark the chunks that changed (Server only) */
+	void SetFlow(int32 InRoomID, const FVector& InOrigin, const FVector& InCellSize, const FIntVector& InDimensions,
+	             const TArray<FVector>& Forces);
+
+	/** Called by the chunk array when a chunk arrives (Client only) */
+	void OnChunkReceived() { bFlowDirty = true; }
+
+	/** Flow as clients decode it, X fastest. The server simulates with this too so both sides agree on the wind */
+	void DequantizeFlow(TArray<FVector>& OutForces) const;
+
+	int32 GetRoomID() const { return RoomID; }
+
+	/** Origin and cell size as they reach clients, rounded like FVector_NetQuantize serializes them */
+	FVector GetOrigin() const { return Origin; }
+
+	FVector GetCellSize() const { return CellSize; }
+
+protected:
+	/** Decode every chunk and hand the flow to the wind field (Client only) */
+	void PublishReceivedFlow();
+
+	UPROPERTY(Replicated)
+	int32 RoomID = INDEX_NONE;
+
+	UPROPERTY(Replicated)
+	FVector_NetQuantize Origin;
+
+	UPROPERTY(Replicated)
+	FVector_NetQuantize CellSize;
+
+	UPROPERTY(Replicated)
+	FIntVector Dimensions = FIntVector::ZeroValue;
+
+	/** Force the largest quantized value of 127 stands for, larger forces are clamped */
+	UPROPERTY(Replicated)
+	float QuantizationRange = 3000.0f;
+
+	UPROPERTY(Replicated)
+	FALSFlowChunkArray FlowChunks;
+
+	bool bFlowDirty = false;
+};
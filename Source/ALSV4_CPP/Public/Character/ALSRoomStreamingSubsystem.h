@@ -0,0 +1,110 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Character/ALSFlowSolverSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSRoomStreamingSubsystem.generated.h"
+
+class ULevelStreamingDynamic;
+
+/** A room of the station as the streaming knows it */
+struct FALSStreamedRoom
+{
+	// Sub-level holding the room's geometry and gravity sources, instanced at LevelTransform
+	TSoftObjectPtr<UWorld> Level;
+
+	FTransform LevelTransform = FTransform::Identity;
+
+	// World space volume of the room, places the movable actors nobody holds. Left invalid for rooms only known by
+	// their level
+	FBox Bounds = FBox(ForceInit);
+
+	// Rooms reachable from this one, the edges of the room graph
+	TArray<int32> Neighbors;
+
+	// What the room's flow is solved from while it is resident
+	FALSFlowSolveInput FlowInput;
+};
+
+/** Streaming state of one registered room */
+struct FALSRoomStreamingState
+{
+	FALSStreamedRoom Room;
+
+	TWeakObjectPtr<ULevelStreamingDynamic> StreamingLevel;
+
+	bool bResident = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FALSOnRoomResidencyChanged, int32 /*RoomID*/, bool /*bResident*/);
+
+/**
+ * Keeps the rooms around the local players resident. The room a player is predicted to enter next is loaded before
+ * they cross over: its sub-level streams in asynchronously, which registers its gravity sources with the gravity
+ * field, and its flow starts blending in the background. Rooms further away in the room graph than the unload distance
+ * are streamed out and their flow is dropped.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSRoomStreamingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	void RegisterRoom(int32 RoomID, const FALSStreamedRoom& Room);
+
+	void UnregisterRoom(int32 RoomID);
+
+	bool IsRoomResident(int32 RoomID) const;
+
+	// Rooms the room connects to through portals, nullptr for rooms that aren't registered
+	const TArray<int32>* GetRoomNeighbors(int32 RoomID) const;
+
+	// Room whose sub-level instance Level is, INDEX_NONE for levels that aren't a room
+	int32 GetRoomOfLevel(const ULevel* Level) const;
+
+	// Whether Location is inside the bounds of the room, false for rooms without bounds
+	bool IsInRoom(int32 RoomID, const FVector& Location) const;
+
+	// Room whose bounds contain Location, INDEX_NONE if none does
+	int32 GetRoomAtLocation(const FVector& Location) const;
+
+	static UALSRoomStreamingSubsystem* Get(const UObject* WorldContextObject);
+
+	FALSOnRoomResidencyChanged OnRoomResidencyChanged;
+
+protected:
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	void UpdateResidency();
+
+	// Hops from the nearest of Seeds to every room up to MaxDistance hops away
+	void GatherRoomDistances(const TArray<int32>& Seeds, int32 MaxDistance, TMap<int32, int32>& OutDistances) const;
+
+	void LoadRoom(int32 RoomID, FALSRoomStreamingState& State);
+
+	void UnloadRoom(int32 RoomID, FALSRoomStreamingState& State);
+
+	// Broadcast the residency changes LoadRoom and UnloadRoom queued, once nothing iterates Rooms anymore
+	void BroadcastResidencyChanges();
+
+	TMap<int32, FALSRoomStreamingState> Rooms;
+
+	// Room and whether it became resident, in the order the changes happened
+	TArray<TPair<int32, bool>> PendingResidencyChanges;
+
+	float TimeSinceLastUpdate = 0.0f;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -0,0 +1,76 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/RootMotionSource.h"
+#include "Library/ALSCharacterStructLibrary.h"
+#include "ALSRootMotionSource_Mantle.generated.h"
+
+class UCurveFloat;
+
+/**
+ * Mantle driven through the character movement component, so it is predicted, saved with the move and replayed on
+ * corrections. Evaluates the same position/correction blend the mantle timeline used, on the source's own clock.
+ */
+USTRUCT()
+struct ALSV4_CPP_API FALSRootMotionSource_Mantle : public FRootMotionSource
+{
+	GENERATED_USTRUCT_BODY()
+
+	FALSRootMotionSource_Mantle();
+
+	virtual ~FALSRootMotionSource_Mantle() {}
+
+	UPROPERTY()
+	FALSMantleParams MantleParams;
+
+	// Initial blend into the position/correction curve, sampled from 0 at the mantle's starting position
+	UPROPERTY()
+	UCurveFloat* BlendInCurve = nullptr;
+
+	UPROPERTY()
+	FALSComponentAndTransform MantleLedgeLS;
+
+	UPROPERTY()
+	FTransform MantleActualStartOffset = FTransform::Identity;
+
+	UPROPERTY()
+	FTransform MantleAnimatedStartOffset = FTransform::Identity;
+
+	// Set the duration from the position/correction curve length and play rate
+	void InitDuration();
+
+	// World transform the character should have at the given timeline position
+	FTransform GetMantleTransform(float PlaybackPosition) const;
+
+	virtual FRootMotionSource* Clone() const override;
+
+	virtual bool Matches(const FRootMotionSource* Other) const override;
+
+	virtual bool MatchesAndHasSameState(const FRootMotionSource* Other) const override;
+
+	virtual void PrepareRootMotion(float SimulationTime, float MovementTickTime, const ACharacter& Character,
+	                               const UCharacterMovementComponent& MoveComponent) override;
+
+	virtual bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) override;
+
+	virtual UScriptStruct* GetScriptStruct() const override;
+
+	virtual FString ToSimpleString() const override;
+
+	virtual void AddReferencedObjects(class FReferenceCollector& Collector) override;
+};
+
+template <>
+struct TStructOpsTypeTraits<FALSRootMotionSource_Mantle> : public TStructOpsTypeTraitsBase2<FALSRootMotionSource_Mantle>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithCopy = true
+	};
+};
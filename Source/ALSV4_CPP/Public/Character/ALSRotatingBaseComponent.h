@@ -0,0 +1,100 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ALSRotatingBaseComponent.generated.h"
+
+/** Spin of a rotating base from StartTime on, in synchronized server time */
+USTRUCT()
+struct FALSRotatingBaseSpin
+{
+	GENERATED_BODY()
+
+	/** Degrees per second around the spin axis */
+	UPROPERTY()
+	float Rate = 0.0f;
+
+	/** Spin angle at StartTime, in degrees */
+	UPROPERTY()
+	float StartAngle = 0.0f;
+
+	UPROPERTY()
+	float StartTime = 0.0f;
+};
+
+/**
+ * Declares its owner as a base spinning at a known rate around a fixed axis, e.g. a station section.
+ * Characters standing on it follow the spin analytically instead of diffing base transforms every tick,
+ * and can take their gravity from the centrifugal acceleration of the spin.
+ */
+UCLASS(ClassGroup = (ALS), meta = (BlueprintSpawnableComponent))
+class ALSV4_CPP_API UALSRotatingBaseComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UALSRotatingBaseComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void BeginPlay() override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
+	                           FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Change the spin rate without a jump in the spin angle (Server only) */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "ALS|Rotating Base")
+	void SetSpinRate(float NewRate);
+
+	UFUNCTION(BlueprintPure, Category = "ALS|Rotating Base")
+	float GetSpinRate() const { return Spin.Rate; }
+
+	/** Spin angle at the current synchronized server time, in degrees */
+	float GetSpinAngle() const;
+
+	FVector GetWorldSpinAxis() const;
+
+	FVector GetWorldPivot() const;
+
+	/** Pose the owner at the current spin angle, once per frame however often it is called */
+	void UpdateBasePose();
+
+	/** Outward direction and magnitude of the centrifugal acceleration at Location, false when it has none */
+	bool GetCentrifugalGravity(const FVector& Location, FVector& OutDirection, float& OutAcceleration) const;
+
+	/** Spin axis in the owner's local space */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Rotating Base")
+	FVector SpinAxis = FVector::UpVector;
+
+	/** Point on the spin axis in the owner's local space */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Rotating Base")
+	FVector PivotOffset = FVector::ZeroVector;
+
+	/** Degrees per second the base starts spinning at */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Rotating Base")
+	float InitialSpinRate = 0.0f;
+
+	/** Rotate the owner from the spin angle. Off when something else, e.g. StationControl, already rotates it at the same rate */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Rotating Base")
+	bool bDriveRotation = true;
+
+	/** Characters standing on the base, and falling off it, take their gravity from the spin */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "ALS|Rotating Base")
+	bool bCentrifugalGravity = false;
+
+protected:
+	float GetServerTime() const;
+
+	UPROPERTY(Replicated)
+	FALSRotatingBaseSpin Spin;
+
+	/** Owner rotation at spin angle zero */
+	FQuat BaseRotation = FQuat::Identity;
+
+	uint64 LastPoseFrame = 0;
+};
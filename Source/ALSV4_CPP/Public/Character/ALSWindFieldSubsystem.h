@@ -0,0 +1,70 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSWindFieldSubsystem.generated.h"
+
+class AALSBaseCharacter;
+
+/** Flow of one room, one force per grid point. Point (X, Y, Z) sits at Origin + (X, Y, Z) * CellSize */
+struct FALSWindGrid
+{
+	FVector Origin = FVector::ZeroVector;
+
+	FVector CellSize = FVector(100.0f);
+
+	FIntVector Dimensions = FIntVector::ZeroValue;
+
+	TArray<FVector> Forces;
+};
+
+/**
+ * Wind of every registered character, sampled from the flow grid of the room they are in in one pass before actors
+ * tick. Characters only read their FALSWindFieldSample afterwards. Rooms without a grid fall back to the GridSample
+ * the room's data helper writes into the character.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSWindFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Replace the flow grid of a room, Forces holds Dimensions.X * Dimensions.Y * Dimensions.Z points, X fastest
+	void SetRoomFlow(int32 RoomID, const FVector& Origin, const FVector& CellSize, const FIntVector& Dimensions,
+	                 TArray<FVector> Forces);
+
+	void ClearRoomFlow(int32 RoomID);
+
+	void RegisterCharacter(AALSBaseCharacter* Character);
+
+	// Trilinear flow at Location in the room's grid, false when the room has none
+	bool SampleRoomFlow(int32 RoomID, const FVector& Location, FVector& OutForce) const;
+
+	static UALSWindFieldSubsystem* Get(const UObject* WorldContextObject);
+
+	// Ease Smoothed towards Force over DeltaSeconds and bound it, by ALS.WindField.SmoothingRate and MaxForce
+	static FVector SmoothForce(const FVector& Smoothed, const FVector& Force, float DeltaSeconds);
+
+protected:
+	void OnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	static FVector SampleGrid(const FALSWindGrid& Grid, const FVector& Location);
+
+	TMap<int32, FALSWindGrid> RoomGrids;
+
+	TArray<TWeakObjectPtr<AALSBaseCharacter>> Characters;
+
+	FDelegateHandle PreActorTickHandle;
+};
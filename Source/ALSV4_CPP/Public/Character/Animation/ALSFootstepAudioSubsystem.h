@@ -0,0 +1,53 @@
+// Project:         Advanced Locomotion System V4 on C++
+// Source Code:     https://github.com/dyanikoglu/ALSV4_CPP
+// Original Author: Doğa Can Yanıkoğlu
+// Contributors:
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "ALSFootstepAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USceneComponent;
+class USoundBase;
+
+DECLARE_STATS_GROUP(TEXT("ALSFootsteps"), STATGROUP_ALSFootsteps, STATCAT_Advanced);
+
+/**
+ * Per world pool of footstep audio components. Footsteps outside audible range are skipped, and once the
+ * concurrency cap is reached a new footstep only plays by replacing a playing one with a lower priority.
+ */
+UCLASS()
+class ALSV4_CPP_API UALSFootstepAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	// Play the sound attached to the component, returns the component used or nullptr if the footstep was skipped
+	UAudioComponent* PlayFootstep(USoundBase* Sound, USceneComponent* AttachTo, FName AttachPointName,
+	                              float VolumeMultiplier, float PitchMultiplier, int32 FootstepType);
+
+	static UALSFootstepAudioSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+	// Priority of a footstep at the given distance, negative when it can't be heard
+	float GetFootstepPriority(const USceneComponent* AttachTo, const FVector& Location, float AudibleRange,
+	                          float VolumeMultiplier) const;
+
+	// Idle or new component, or the lowest priority playing one if it is below Priority. INDEX_NONE if none.
+	int32 AcquireComponent(float Priority);
+
+	UPROPERTY()
+	TArray<UAudioComponent*> Components;
+
+	// Priority each component was last started with
+	TArray<float> Priorities;
+};
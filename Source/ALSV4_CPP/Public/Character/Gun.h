@@ -3,6 +3,8 @@
 #include "Gun.generated.h"
 
 class AImpactEffect;
+class UPhysicalMaterial;
+class UPrimitiveComponent;
 
 USTRUCT()
 struct FInstantHitInfo
@@ -19,6 +21,92 @@ struct FInstantHitInfo
 		int32 RandomSeed;
 };
 
+/** one trace of a batched hit report */
+USTRUCT()
+struct FInstantHitReport
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** index of the trace in its batch, its random seed is the batch seed plus this; up to PelletsPerShot * MaxShotsPerFrame */
+	UPROPERTY()
+		uint16 ShotIndex;
+
+	/** false for misses, which only carry the shoot direction */
+	UPROPERTY()
+		uint8 bBlockingHit : 1;
+
+	/** actor that was hit, sent as its net GUID; null for world geometry */
+	UPROPERTY()
+		AActor* HitActor;
+
+	UPROPERTY()
+		FVector_NetQuantize ImpactPoint;
+
+	UPROPERTY()
+		FVector_NetQuantizeNormal ImpactNormal;
+
+	UPROPERTY()
+		FVector_NetQuantizeNormal ShootDir;
+
+	/** bone, component and surface of the hit, for location based damage and impact effects */
+	UPROPERTY()
+		FName BoneName;
+
+	UPROPERTY()
+		UPrimitiveComponent* HitComponent;
+
+	UPROPERTY()
+		UPhysicalMaterial* PhysMaterial;
+
+	FInstantHitReport()
+		: ShotIndex(0)
+		, bBlockingHit(false)
+		, HitActor(nullptr)
+		, HitComponent(nullptr)
+		, PhysMaterial(nullptr)
+	{}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FInstantHitReport> : public TStructOpsTypeTraitsBase2<FInstantHitReport>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/** every trace fired in one frame, sent to the server in a single RPC */
+USTRUCT()
+struct FInstantHitBatch
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+		FVector_NetQuantize Origin;
+
+	UPROPERTY()
+		int32 RandomSeed;
+
+	UPROPERTY()
+		float ReticleSpread;
+
+	/** server world time as seen by the client when it fired, used to rewind hit targets */
+	UPROPERTY()
+		float ClientFireTime;
+
+	UPROPERTY()
+		TArray<FInstantHitReport> Shots;
+
+	FInstantHitBatch()
+		: RandomSeed(0)
+		, ReticleSpread(0.0f)
+		, ClientFireTime(0.0f)
+	{}
+};
+
 USTRUCT()
 struct FInstantWeaponData
 {
@@ -52,7 +140,7 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category = WeaponStat)
 		TSubclassOf<UDamageType> DamageType;
 
-	/** hit verification: scale for bounding box of hit actor */
+	/** hit verification: scale for bounding box of hit actors without a hitbox history */
 	UPROPERTY(EditDefaultsOnly, Category = HitVerification)
 		float ClientSideHitLeeway;
 
@@ -60,6 +148,10 @@ struct FInstantWeaponData
 	UPROPERTY(EditDefaultsOnly, Category = HitVerification)
 		float AllowedViewDotHitDir;
 
+	/** traces per shot, spread over the current cone when more than one */
+	UPROPERTY(EditDefaultsOnly, Category = WeaponStat, meta = (ClampMin = "1", ClampMax = "32"))
+		int32 PelletsPerShot;
+
 	/** defaults */
 	FInstantWeaponData()
 	{
@@ -72,6 +164,7 @@ struct FInstantWeaponData
 		DamageType = UDamageType::StaticClass();
 		ClientSideHitLeeway = 200.0f;
 		AllowedViewDotHitDir = 0.8f;
+		PelletsPerShot = 1;
 	}
 };
 
@@ -118,16 +211,30 @@ protected:
 	/** current spread from continuous firing */
 	float CurrentFiringSpread;
 
+	/** [local] hits and misses of this frame waiting to be sent to the server */
+	FInstantHitBatch PendingHitBatch;
+
+	/** [local] traces fired into the pending batch, reported or not */
+	int32 PendingShotCount;
+
 	//////////////////////////////////////////////////////////////////////////
 	// Weapon usage
 
-	/** server notified of hit from client to verify */
+	/** server notified of every hit and miss of a frame from client to verify */
 	UFUNCTION(reliable, server, WithValidation)
-		void ServerNotifyHit(const FHitResult& Impact, FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread,const FVector& Origin);
+		void ServerNotifyHitBatch(const FInstantHitBatch& Batch);
+
+	/** [server] verify a hit reported by the client */
+	void HandleClientHit(const FHitResult& Impact, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread, const FVector& Origin, float ClientFireTime);
+
+	/** [server] show trail FX for a miss reported by the client */
+	void HandleClientMiss(const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
-	/** server notified of miss to show trail FX */
-	UFUNCTION(unreliable, server, WithValidation)
-		void ServerNotifyMiss(FVector_NetQuantizeNormal ShootDir, int32 RandomSeed, float ReticleSpread);
+	/** [local] add a trace to the batch sent to the server at the end of the frame */
+	void QueueHitReport(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
+
+	/** [local] send the batched hits of this frame */
+	virtual void FlushFiredShots() override;
 
 	/** process the instant hit and notify the server if necessary */
 	void ProcessInstantHit(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
@@ -135,6 +242,12 @@ protected:
 	/** continue processing the instant hit, as if it has been confirmed by the server */
 	void ProcessInstantHit_Confirmed(const FHitResult& Impact, const FVector& Origin, const FVector& ShootDir, int32 RandomSeed, float ReticleSpread);
 
+	/** [server] check a client hit on a moving actor, rewinding its hitboxes to the time the client fired */
+	bool ValidateClientHit(const FHitResult& Impact, const FVector& Origin, float ClientFireTime) const;
+
+	/** [local] server world time as this client sees it, which is when the targets it shot at were where it saw them */
+	float GetClientFireTime() const;
+
 	/** check if weapon should deal damage to actor */
 	bool ShouldDealDamage(AActor* TestActor) const;
 
@@ -98,11 +98,9 @@ public:
 	/** spawn effect */
 	virtual void PostInitializeComponents() override;
 
-protected:
-
 	/** get FX for material type */
-	UParticleSystem* GetImpactFX(TEnumAsByte<EPhysicalSurface> SurfaceType) const;
+	UParticleSystem* GetImpactFX(EPhysMaterialType::Type MaterialType) const;
 
 	/** get sound for material type */
-	USoundCue* GetImpactSound(TEnumAsByte<EPhysicalSurface> SurfaceType) const;
+	USoundCue* GetImpactSound(EPhysMaterialType::Type MaterialType) const;
 };
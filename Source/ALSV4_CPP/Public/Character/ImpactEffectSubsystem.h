@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Character/AAADTypes.h"
+#include "ImpactEffectSubsystem.generated.h"
+
+class AImpactEffect;
+class UAudioComponent;
+class UDecalComponent;
+class UParticleSystemComponent;
+
+DECLARE_STATS_GROUP(TEXT("ImpactEffects"), STATGROUP_ImpactEffects, STATCAT_Advanced);
+
+/** everything needed to play one impact, replaces spawning an AImpactEffect actor per hit */
+struct FImpactEffectRequest
+{
+	/** effect class whose defaults provide the FX, sounds and decal */
+	TSubclassOf<AImpactEffect> Template;
+
+	/** surface that was hit */
+	EPhysMaterialType::Type MaterialType;
+
+	/** impact point */
+	FVector Location;
+
+	/** surface normal at the impact point */
+	FVector Normal;
+
+	/** component hit, decals follow it when it can move */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/** bone hit on skeletal meshes */
+	FName BoneName;
+
+	FImpactEffectRequest()
+		: MaterialType(EPhysMaterialType::Unknown)
+		, Location(ForceInitToZero)
+		, Normal(FVector::UpVector)
+		, BoneName(NAME_None)
+	{
+	}
+
+	FImpactEffectRequest(TSubclassOf<AImpactEffect> InTemplate, const FHitResult& Impact);
+
+	/** map a physical surface from the project settings to our material types */
+	static EPhysMaterialType::Type GetMaterialType(EPhysicalSurface SurfaceType);
+};
+
+/** recycled components for one material type */
+USTRUCT()
+struct FImpactEffectPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Particles;
+
+	UPROPERTY()
+	TArray<UAudioComponent*> Sounds;
+
+	/** next component to steal when the pool is full and everything is still playing */
+	int32 NextParticle = 0;
+
+	int32 NextSound = 0;
+};
+
+/**
+ * Plays weapon impacts from pooled components instead of spawning an actor per hit.
+ * Particles and sounds are pooled per material type, decals share one ring of the most recent ones,
+ * and impacts too far from every local view are dropped.
+ */
+UCLASS()
+class ALSV4_CPP_API UImpactEffectSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	/** play the impact described by the request */
+	void SpawnImpact(const FImpactEffectRequest& Request);
+
+	/** subsystem of the world the context object lives in, null on dedicated servers */
+	static UImpactEffectSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+
+	/** take a particle component from the pool, preferring an idle one already using the template */
+	UParticleSystemComponent* AcquireParticles(FImpactEffectPool& Pool, UParticleSystem* Template);
+
+	/** take an audio component from the pool */
+	UAudioComponent* AcquireSound(FImpactEffectPool& Pool);
+
+	/** take the slot of the oldest decal once the budget is reached */
+	UDecalComponent* AcquireDecal(float LifeSpan);
+
+	/** hide decals that outlived their lifespan */
+	void ExpireDecals();
+
+	/** is the location close enough to any local view to be worth playing */
+	bool IsWithinCullDistance(const FVector& Location) const;
+
+	/** pools indexed by EPhysMaterialType */
+	UPROPERTY()
+	TArray<FImpactEffectPool> Pools;
+
+	/** decal ring, oldest at NextDecal once full */
+	UPROPERTY()
+	TArray<UDecalComponent*> Decals;
+
+	/** world time each decal in the ring expires at */
+	TArray<float> DecalExpireTimes;
+
+	int32 NextDecal;
+
+	/** Handle for efficient management of ExpireDecals timer */
+	FTimerHandle TimerHandle_ExpireDecals;
+};
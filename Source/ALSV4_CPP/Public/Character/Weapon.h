@@ -61,6 +61,10 @@ struct FWeaponData
 	UPROPERTY(EditDefaultsOnly, Category = WeaponStat)
 		float NoAnimReloadDuration;
 
+	/** most shots fired in a single frame when the fire rate outpaces the frame rate */
+	UPROPERTY(EditDefaultsOnly, Category = WeaponStat, meta = (ClampMin = "1", ClampMax = "255"))
+		int32 MaxShotsPerFrame;
+
 	/** defaults */
 	FWeaponData()
 	{
@@ -71,6 +75,7 @@ struct FWeaponData
 		InitialClips = 4;
 		TimeBetweenShots = 0.2f;
 		NoAnimReloadDuration = 1.0f;
+		MaxShotsPerFrame = 4;
 	}
 };
 
@@ -267,6 +272,9 @@ class ALSV4_CPP_API AWeapon : public AActor
 	UPROPERTY(Config)
 		bool bAllowAutomaticWeaponCatchup = true;
 
+	/** Shots that came due between two refire timer ticks, fired together with the next one */
+	int32 PendingSubFrameShots;
+
 	/** check if Weapon has infinite ammo (include owner's cheats) */
 	bool HasInfiniteAmmo() const;
 
@@ -476,7 +484,10 @@ protected:
 
 	/** [server] fire & update ammo */
 	UFUNCTION(reliable, server, WithValidation)
-		void ServerHandleFiring();
+		void ServerHandleFiring(uint8 NumShots);
+
+	/** [local] send whatever the shots of this frame queued for the server */
+	virtual void FlushFiredShots() {}
 
 	/** [local + server] handle Weapon refire, compensating for slack time if the timer can't sample fast enough */
 	void HandleReFiring();
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WeaponFXSubsystem.generated.h"
+
+class AWeapon;
+class UParticleSystem;
+class UParticleSystemComponent;
+
+DECLARE_STATS_GROUP(TEXT("WeaponFX"), STATGROUP_WeaponFX, STATCAT_Advanced);
+
+/** recycled cosmetic components for one weapon class */
+USTRUCT()
+struct FWeaponFXPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Trails;
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> MuzzleFlashes;
+};
+
+/**
+ * Plays bullet trails and muzzle flashes of remote weapons from pools kept per weapon class.
+ * Pools never grow past their budget, effects that would need more, or that nobody could see, are dropped.
+ */
+UCLASS()
+class ALSV4_CPP_API UWeaponFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	/** play a trail from Origin towards EndPoint, passed to the template through TargetParam */
+	UParticleSystemComponent* SpawnTrail(const AWeapon* Weapon, UParticleSystem* Template, const FVector& Origin,
+		const FVector& EndPoint, FName TargetParam);
+
+	/** play a muzzle flash attached to the weapon mesh */
+	UParticleSystemComponent* SpawnMuzzleFlash(const AWeapon* Weapon, UParticleSystem* Template,
+		UPrimitiveComponent* AttachTo, FName AttachPoint);
+
+	/** subsystem of the world the context object lives in, null on dedicated servers */
+	static UWeaponFXSubsystem* Get(const UObject* WorldContextObject);
+
+protected:
+
+	/** idle component from the list or a new one within MaxComponents, null when the budget is used up */
+	UParticleSystemComponent* Acquire(TArray<UParticleSystemComponent*>& Components, int32 MaxComponents,
+		UParticleSystem* Template);
+
+	/** squared distance from the closest local view to the segment, zero when there is no local view */
+	float GetViewDistSquared(const FVector& Start, const FVector& End) const;
+
+	/** pools by weapon class */
+	UPROPERTY()
+	TMap<UClass*, FWeaponFXPool> Pools;
+};
@@ -139,6 +139,39 @@ enum class EALSMantleType : uint8
 	FallingCatch
 };
 
+UENUM(BlueprintType)
+enum class EALSGravitySourceShape : uint8
+{
+	Point,
+	Cylinder,
+	Box,
+	Spline
+};
+
+UENUM(BlueprintType)
+enum class EALSCustomMovementMode : uint8
+{
+	None,
+	ZeroGravity
+};
+
+UENUM(BlueprintType)
+enum class EALSForceChannel : uint8
+{
+	Wind,
+	GravityWell,
+	Entanglement,
+	Scripted
+};
+
+UENUM(BlueprintType)
+enum class EALSMovementLOD : uint8
+{
+	Full,
+	Reduced,
+	Minimal
+};
+
 UENUM(BlueprintType)
 enum class EALSMovementDirection : uint8
 {
@@ -10,6 +10,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DataTable.h"
+#include "Engine/NetSerialization.h"
 #include "Library/ALSCharacterEnumLibrary.h"
 
 #include "ALSCharacterStructLibrary.generated.h"
@@ -139,6 +140,26 @@ struct FALSMantleParams
 	FVector StartingOffset;
 };
 
+// Mantle start sent to simulated proxies so they can play the montage, the movement itself comes from the CMC
+USTRUCT(BlueprintType)
+struct FALSReplicatedMantle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float MantleHeight = 0.0f;
+
+	UPROPERTY()
+	FALSComponentAndTransform MantleLedgeWS;
+
+	UPROPERTY()
+	EALSMantleType MantleType = EALSMantleType::HighMantle;
+
+	// Bumped on every mantle so back to back mantles onto the same ledge still replicate
+	UPROPERTY()
+	uint8 MantleCount = 0;
+};
+
 USTRUCT(BlueprintType)
 struct FALSMantleTraceSettings
 {
@@ -246,3 +267,77 @@ struct FALSRotateInPlaceAsset
 	UPROPERTY(EditAnywhere)
 	float FastPlayRate = 1.0f;
 };
+
+/** Parameters of the movement component's external force channels. Replicated instead of the forces
+ * themselves, so the server and the predicting client evaluate the same forces inside every move. */
+USTRUCT(BlueprintType)
+struct FALSForceChannels
+{
+	GENERATED_BODY()
+
+	/** Gravity well pulling towards WellLocation, pushing for a negative strength, fading out to nothing at WellRadius */
+	UPROPERTY(BlueprintReadOnly)
+	FVector_NetQuantize WellLocation = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	float WellStrength = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float WellRadius = 3000.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector_NetQuantize10 EntanglementForce = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector_NetQuantize10 ScriptedForce = FVector::ZeroVector;
+};
+
+/** Wind at a character, written once per frame by UALSWindFieldSubsystem for every registered character */
+USTRUCT(BlueprintType)
+struct FALSWindFieldSample
+{
+	GENERATED_BODY()
+
+	/** Flow at the character's location, what the movement component's wind channel eases towards */
+	UPROPERTY(BlueprintReadOnly)
+	FVector Force = FVector::ZeroVector;
+
+	/** Force eased towards over time and clamped, what the ragdoll is pushed with */
+	UPROPERTY(BlueprintReadOnly)
+	FVector SmoothedForce = FVector::ZeroVector;
+
+	/** Smoothed force less the part the ragdoll already rides along with */
+	UPROPERTY(BlueprintReadOnly)
+	FVector RagdollForce = FVector::ZeroVector;
+};
+
+/** Aim and gravity block replicated to simulated proxies. Each send only writes the fields that
+ * moved past their quantization step since the state the receiving connection last acknowledged. */
+USTRUCT(BlueprintType)
+struct FALSReplicatedEssentials
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector CurrentAcceleration = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FRotator ControlRotation = FRotator::ZeroRotator;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector GravityDirection = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FRotator QuatYawRotation = FRotator::ZeroRotator;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FALSReplicatedEssentials> : public TStructOpsTypeTraitsBase2<FALSReplicatedEssentials>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};